@@ -0,0 +1,146 @@
+#ifndef CODEGENSTATS_H
+#define CODEGENSTATS_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "asmjit/asmjit.h"
+
+// Counts the instructions an assembler emits by watching its log.
+// The assembler logs an instruction, a bound label or a directive as one complete
+// line, a comment as its text followed by a separate "\n", so only whole lines
+// that are not labels (L1:) or directives (.align, .section, .db) are counted.
+class InstructionCounter : public asmjit::Logger {
+public:
+    asmjit::Error _log(const char *data, size_t size) noexcept override {
+        if (size == SIZE_MAX) size = std::strlen(data);
+        if (size < 2 || data[size - 1] != '\n') return asmjit::kErrorOk;
+
+        size_t begin = 0;
+        while (begin < size && data[begin] == ' ') ++begin;
+        if (data[begin] == '.' || data[size - 2] == ':') return asmjit::kErrorOk;
+        ++count_;
+        return asmjit::kErrorOk;
+    }
+
+    void reset() {
+        count_ = 0;
+    }
+
+    [[nodiscard]] size_t count() const {
+        return count_;
+    }
+
+private:
+    size_t count_ = 0;
+};
+
+struct CodegenEntry {
+    size_t bytes;
+    size_t instructions;
+};
+
+/**
+ * CodegenStats
+ *  - While enabled, records the byte size and instruction count of every word
+ *    as it is named in the dictionary, primitives and colon definitions alike.
+ *  - A name defined more than once is recorded as name#2, name#3, ... in order.
+ *  - Baselines are plain text, one "name bytes instructions" line per word,
+ *    compare() reports words that grew past the tolerance.
+ */
+class CodegenStats {
+public:
+    static CodegenStats &getInstance() {
+        static CodegenStats instance;
+        return instance;
+    }
+
+    CodegenStats(const CodegenStats &) = delete;
+    CodegenStats &operator=(const CodegenStats &) = delete;
+
+    void record(const std::string &name, const size_t bytes, const size_t instructions) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t seen = ++definitions_[name];
+        const std::string key = seen == 1 ? name : name + "#" + std::to_string(seen);
+        entries_.emplace_back(key, CodegenEntry{bytes, instructions});
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        definitions_.clear();
+        entries_.clear();
+    }
+
+    [[nodiscard]] const std::vector<std::pair<std::string, CodegenEntry> > &entries() const {
+        return entries_;
+    }
+
+    static std::map<std::string, CodegenEntry> loadBaseline(const std::string &path) {
+        std::map<std::string, CodegenEntry> baseline;
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            std::string name;
+            CodegenEntry entry{};
+            if (fields >> name >> entry.bytes >> entry.instructions) {
+                baseline[name] = entry;
+            }
+        }
+        return baseline;
+    }
+
+    bool writeBaseline(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "# name bytes instructions, regenerate with jitforth_codegen_tests --update\n";
+        for (const auto &[name, entry]: entries_) {
+            out << name << ' ' << entry.bytes << ' ' << entry.instructions << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Number of words larger than the baseline by more than tolerancePercent,
+    // in bytes or in instructions. Words missing from the baseline are listed as new.
+    size_t compare(const std::map<std::string, CodegenEntry> &baseline, const double tolerancePercent,
+                   std::ostream &report) const {
+        size_t regressions = 0;
+        auto grew = [tolerancePercent](const size_t now, const size_t before) {
+            return static_cast<double>(now) > before * (1.0 + tolerancePercent / 100.0);
+        };
+        for (const auto &[name, entry]: entries_) {
+            const auto it = baseline.find(name);
+            if (it == baseline.end()) {
+                report << "new     " << name << ' ' << entry.bytes << " bytes " << entry.instructions
+                        << " instructions" << std::endl;
+                continue;
+            }
+            const CodegenEntry &before = it->second;
+            if (grew(entry.bytes, before.bytes) || grew(entry.instructions, before.instructions)) {
+                ++regressions;
+                report << "GREW    " << name << ' ' << before.bytes << " -> " << entry.bytes << " bytes, "
+                        << before.instructions << " -> " << entry.instructions << " instructions" << std::endl;
+            } else if (entry.bytes < before.bytes || entry.instructions < before.instructions) {
+                report << "shrank  " << name << ' ' << before.bytes << " -> " << entry.bytes << " bytes, "
+                        << before.instructions << " -> " << entry.instructions << " instructions" << std::endl;
+            }
+        }
+        return regressions;
+    }
+
+private:
+    CodegenStats() = default;
+
+    std::map<std::string, size_t> definitions_;
+    std::vector<std::pair<std::string, CodegenEntry> > entries_;
+    std::mutex mutex_;
+};
+
+#endif //CODEGENSTATS_H
@@ -0,0 +1,89 @@
+#ifndef COMPILEPOOL_H
+#define COMPILEPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * CompilePool
+ *  - A fixed set of worker threads that compile definitions in the background.
+ *  - Each worker has its own thread-local JitContext, loop label stack and locals,
+ *    the JitRuntime they publish into is shared.
+ *  - Workers never touch the dictionary for writing, the caller adds the results
+ *    in source order once a batch has finished.
+ */
+class CompilePool {
+public:
+    static CompilePool &getInstance() {
+        static CompilePool instance;
+        return instance;
+    }
+
+    CompilePool(const CompilePool &) = delete;
+    CompilePool &operator=(const CompilePool &) = delete;
+
+    // Queue a job, the future carries its result or its exception.
+    template<typename F>
+    auto submit(F job) -> std::future<decltype(job())> {
+        using Result = decltype(job());
+        auto task = std::make_shared<std::packaged_task<Result()> >(std::move(job));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace([task] { (*task)(); });
+        }
+        ready_.notify_one();
+        return result;
+    }
+
+    [[nodiscard]] size_t workerCount() const {
+        return workers_.size();
+    }
+
+private:
+    CompilePool() {
+        unsigned int count = std::thread::hardware_concurrency();
+        if (count == 0) count = 2;
+        for (unsigned int i = 0; i < count; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~CompilePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto &worker: workers_) {
+            worker.join();
+        }
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                if (stopping_ && jobs_.empty()) return;
+                job = std::move(jobs_.front());
+                jobs_.pop();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()> > jobs_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_ = false;
+};
+
+#endif //COMPILEPOOL_H
@@ -24,6 +24,8 @@ inline void compileWord(const std::string& wordName, const std::string& compileT
 
     // Start compiling the new word
     JitGenerator::genPrologue();
+    if (jc.wordStats) jc.wordStats->setName(wordName);
+    if (jc.traceId) ExecutionTrace::getInstance().setName(jc.traceId, wordName);
 
     const auto words = split(compileText);
 
@@ -34,6 +36,20 @@ inline void compileWord(const std::string& wordName, const std::string& compileT
     }
     if (logging) printf("\n");
 
+    // a literal too big for a cell throws, drop the half generated word first
+    const auto scanLiteral = [&](const std::string& text, Token& literal)
+    {
+        try
+        {
+            return scan_literal(text, literal);
+        }
+        catch (const std::runtime_error&)
+        {
+            jc.resetContext();
+            throw;
+        }
+    };
+
     size_t i = 0;
     while (i < words.size())
     {
@@ -52,8 +68,7 @@ inline void compileWord(const std::string& wordName, const std::string& compileT
             else if (fword->compiledFunc)
             {
                 if (logging) printf("Generating call for compiled function of word: %s\n", word.c_str());
-                // Assuming JitGenerator::genCall is the method to generate call for compiled function
-                JitGenerator::genCall(fword->compiledFunc);
+                JitGenerator::genCallWord(fword);
             }
             else if (fword->immediateFunc)
             {
@@ -79,49 +94,20 @@ inline void compileWord(const std::string& wordName, const std::string& compileT
             if (logging) printf(" local variable: %s at %d\n", word.c_str(), o);
             JitGenerator::genPushLocal(jc.offset);
         }
-        else if (is_float(word))
+        else if (Token literal; scanLiteral(word, literal))
         {
-            try
+            if (literal.type == TOKEN_FLOAT)
             {
-                double floatingNumber = parseFloat(word);
-                jc.double_A = floatingNumber;
+                jc.double_A = literal.float_value;
                 JitGenerator::genPushDouble();
                 if (logging) printf("Generated code for float: %s\n", word.c_str());
             }
-            catch (const std::invalid_argument& e)
-            {
-                if (logging) std::cout << "Error: Invalid float: " << word << std::endl;
-                jc.resetContext();
-                return;
-            }
-            catch (const std::out_of_range& e)
-            {
-                if (logging) std::cout << "Error: Float out of range: " << word << std::endl;
-                jc.resetContext();
-                return;
-            }
-        }
-        else if (is_number(word))
-        {
-            try
+            else
             {
-                uint64_t number = parseNumber(word);
-                jc.uint64_A = number;
+                jc.uint64_A = static_cast<uint64_t>(literal.int_value);
                 JitGenerator::genPushLong();
                 if (logging) printf("Generated code for number: %s\n", word.c_str());
             }
-            catch (const std::invalid_argument& e)
-            {
-                if (logging) std::cout << "Error: Invalid number: " << word << std::endl;
-                jc.resetContext();
-                return;
-            }
-            catch (const std::out_of_range& e)
-            {
-                if (logging) std::cout << "Error: Number out of range: " << word << std::endl;
-                jc.resetContext();
-                return;
-            }
         }
         else
         {
@@ -148,6 +134,7 @@ inline void compileWord(const std::string& wordName, const std::string& compileT
               f,
               nullptr,
               nullptr, sourceCode);
+    d.getLatestWord()->flags |= WORD_COLON;
 
 
     if (logging)
@@ -40,66 +40,6 @@ inline void exec(ForthFunction f)
     f();
 }
 
-inline double parseFloat(const std::string& word) {
-    if (word.empty()) {
-        throw std::invalid_argument("Empty string is not a valid number");
-    }
-
-    size_t startIndex = 0;
-    bool isNegative = false;
-
-    // Check for an optional leading minus sign for decimal numbers
-    if (word[0] == '-') {
-        isNegative = true;
-        startIndex = 1;
-    }
-
-    // Default to floating-point parsing
-    double number = std::stod(word.substr(startIndex)); // Convert to double
-
-    // Apply the negative sign if necessary
-    if (isNegative) {
-        number = -number;
-    }
-
-    return number;
-}
-
-
-inline int64_t parseNumber(const std::string& word) {
-    if (word.empty()) {
-        throw std::invalid_argument("Empty string is not a valid number");
-    }
-
-    size_t startIndex = 0;
-    bool isNegative = false;
-
-    // Check for an optional leading minus sign for decimal numbers
-    if (word[0] == '-') {
-        isNegative = true;
-        startIndex = 1;
-    }
-
-    // Handle hexadecimal and binary prefixes
-    if (startIndex + 2 < word.length() && word[startIndex] == '0') {
-        if (word[startIndex + 1] == 'x' || word[startIndex + 1] == 'X') {
-            return std::stoull(word.substr(startIndex), nullptr, 16); // Hexadecimal (unsigned)
-        } else if (word[startIndex + 1] == 'b' || word[startIndex + 1] == 'B') {
-            return std::stoull(word.substr(startIndex + 2), nullptr, 2); // Binary (unsigned)
-        }
-    }
-
-    // Default to decimal
-    int64_t number = std::stoll(word.substr(startIndex), nullptr, 10); // Decimal
-
-    // Apply the negative sign if necessary
-    if (isNegative) {
-        number = -number;
-    }
-
-    return number;
-}
-
 // also removes comments between ( and )
 inline std::string scanForLiterals(const std::string& compileText)
 {
@@ -0,0 +1,87 @@
+#ifndef EXECUTIONTRACE_H
+#define EXECUTIONTRACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+// Written by the generated code at word entry, see JitGenerator::genTraceEntry.
+// The layout is used by the generated code, next must stay at offset 0.
+struct TraceRing {
+    static constexpr uint64_t SIZE = 1 << 12; // power of two
+
+    uint64_t next;          // entries written so far
+    uint64_t entries[SIZE]; // DS depth in cells << 32 | word id
+};
+
+/**
+ * ExecutionTrace
+ *  - Words compiled with *TRACE ON record their id and the DS depth in a ring
+ *    on every entry, so the last calls before an error can be printed.
+ *  - One ring: Forth code runs on the interpreter thread only, compile workers
+ *    generate code but never run it. Writing takes no lock.
+ *  - Ids index a name table that only grows, like the stats records.
+ */
+class ExecutionTrace {
+public:
+    static ExecutionTrace &getInstance() {
+        static ExecutionTrace instance;
+        return instance;
+    }
+
+    ExecutionTrace(const ExecutionTrace &) = delete;
+    ExecutionTrace &operator=(const ExecutionTrace &) = delete;
+
+    TraceRing *ring() {
+        return &ring_;
+    }
+
+    // id 0 is never handed out
+    uint32_t allocateId() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_.emplace_back();
+        return static_cast<uint32_t>(names_.size() - 1);
+    }
+
+    void setName(const uint32_t id, const std::string &name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id < names_.size()) names_[id] = name;
+    }
+
+    void clear() {
+        ring_.next = 0;
+    }
+
+    // Last count entries, oldest first.
+    void dump(const uint64_t count, std::ostream &out = std::cout) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t written = ring_.next;
+        const uint64_t shown = std::min({count, written, TraceRing::SIZE});
+        if (shown == 0) {
+            out << "Trace is empty, compile words with *TRACE ON" << std::endl;
+            return;
+        }
+        out << "Last " << shown << " of " << written << " traced calls (oldest first)\n";
+        for (uint64_t i = written - shown; i < written; ++i) {
+            const uint64_t entry = ring_.entries[i & (TraceRing::SIZE - 1)];
+            const auto id = static_cast<uint32_t>(entry);
+            const auto depth = static_cast<int32_t>(entry >> 32);
+            const std::string &name = id < names_.size() && !names_[id].empty() ? names_[id] : "?";
+            out << "  " << name << "  depth " << depth << "\n";
+        }
+        out << std::flush;
+    }
+
+private:
+    ExecutionTrace() : names_(1, "") {
+    }
+
+    TraceRing ring_{};
+    std::deque<std::string> names_;
+    std::mutex mutex_;
+};
+
+#endif //EXECUTIONTRACE_H
@@ -5,6 +5,45 @@
 #include "JitGenerator.h"
 #include <string>
 #include <set>
+#include <atomic>
+
+
+namespace
+{
+    // Direct mapped cache of recent lookups, one per thread because compile workers
+    // look words up concurrently. A slot only hits for the generation it was filled in,
+    // adding, renaming or forgetting a word starts a new generation.
+    struct LookupSlot
+    {
+        uint64_t generation = 0;
+        ForthWord* word = nullptr;
+    };
+
+    constexpr size_t LOOKUP_SLOTS = 256; // power of two
+    thread_local LookupSlot lookupCache[LOOKUP_SLOTS];
+
+    // Names are stored lower case, compare case-insensitively without a lower case copy
+    bool sameName(const ForthWord* word, const std::string_view name)
+    {
+        size_t i = 0;
+        while (i < name.size() && word->name[i] == static_cast<char>(std::tolower(static_cast<unsigned char>(name[i]))))
+        {
+            ++i;
+        }
+        return i == name.size() && word->name[i] == '\0';
+    }
+
+    // FNV-1a of the lower case name
+    uint64_t nameHash(const std::string_view name)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : name)
+        {
+            hash = (hash ^ static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c)))) * 1099511628211ull;
+        }
+        return hash;
+    }
+}
 
 
 // Static method to get the singleton instance
@@ -29,6 +68,8 @@ void ForthDictionary::addWord(const char* name,
 {
     std::string lower_name = to_lower(name);
 
+    // keep the compiledFunc slot aligned so it can be patched atomically
+    currentPos = (currentPos + alignof(ForthWord) - 1) & ~(alignof(ForthWord) - 1);
     if (currentPos + sizeof(ForthWord) > memory.size())
     {
         throw std::runtime_error("Dictionary memory overflow");
@@ -44,6 +85,11 @@ void ForthDictionary::addWord(const char* name,
 
     // Correctly set the latest word to the new word
     latestWord = newWord;
+    ++generation;
+    if (compiledFunc != nullptr)
+    {
+        jc.nameCodeRange(reinterpret_cast<void*>(compiledFunc), lower_name);
+    }
 
     // Store the source code in the map
     sourceCodeMap[lower_name] = sourceCode;
@@ -95,19 +141,37 @@ void ForthDictionary::addInterpretOnlyImmediate(const char* name,
 // Find a word in the dictionary
 ForthWord* ForthDictionary::findWord(const char* name) const
 {
-    std::string lower_name = to_lower(name);
-    ForthWord* word = latestWord;
-    while (word != nullptr)
+    return findWord(std::string_view(name));
+}
+
+// Repeated lookups of a name are answered from the cache, the list is walked on a miss
+ForthWord* ForthDictionary::findWord(const std::string_view name) const
+{
+    if (name.size() >= sizeof(ForthWord::name))
+    {
+        return nullptr;
+    }
+    LookupSlot& slot = lookupCache[nameHash(name) & (LOOKUP_SLOTS - 1)];
+    if (slot.generation == generation && slot.word != nullptr && sameName(slot.word, name))
     {
-        if (std::strcmp(word->name, lower_name.c_str()) == 0)
+        return slot.word;
+    }
+    for (ForthWord* word = latestWord; word != nullptr; word = word->link)
+    {
+        if (sameName(word, name))
         {
+            slot = {generation, word};
             return word;
         }
-        word = word->link;
     }
     return nullptr;
 }
 
+uint64_t ForthDictionary::getGeneration() const
+{
+    return generation;
+}
+
 // Allot space in the dictionary
 void ForthDictionary::allot(size_t bytes)
 {
@@ -140,6 +204,32 @@ uint64_t ForthDictionary::getCurrentPos() const
     return (uint64_t)currentPos;
 }
 
+size_t ForthDictionary::bytesUsed() const
+{
+    return currentPos;
+}
+
+size_t ForthDictionary::bytesReserved() const
+{
+    return memory.size();
+}
+
+size_t ForthDictionary::sourceCodeEntries() const
+{
+    return sourceCodeMap.size();
+}
+
+// Characters held by the source map, names and text, not the hash table itself
+size_t ForthDictionary::sourceCodeBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& [name, source] : sourceCodeMap)
+    {
+        bytes += name.size() + source.size();
+    }
+    return bytes;
+}
+
 uint64_t ForthDictionary::getCurrentLocation() const
 {
     return reinterpret_cast<uint64_t>(&memory[currentPos]);
@@ -159,17 +249,7 @@ void ForthDictionary::forgetLastWord()
     }
 
     std::cout << "Forgetting word " << latestWord->name << std::endl;
-
-    // Remove source code entry
-    sourceCodeMap.erase(latestWord->name);
-
-    // Size of the word (this depends on your actual implementation details. Adjust as needed).
-    size_t wordSize = sizeof(ForthWord) + 16; // include the extra allotted space
-    currentPos -= wordSize;
-
-    // Update the latest word pointer
-    ForthWord* previousWord = latestWord->link;
-    latestWord = previousWord;
+    removeLatestWord();
 
     // Additional check to update the linking properly in dictionary
     if (latestWord != nullptr)
@@ -182,6 +262,71 @@ void ForthDictionary::forgetLastWord()
     }
 }
 
+// Forget the given word and everything defined after it, used by MARKER
+void ForthDictionary::forgetThrough(const ForthWord* word)
+{
+    const ForthWord* search = latestWord;
+    while (search != nullptr && search != word)
+    {
+        search = search->link;
+    }
+    if (search == nullptr)
+    {
+        throw std::runtime_error("Word to forget is not in the dictionary");
+    }
+
+    while (latestWord != word)
+    {
+        removeLatestWord();
+    }
+    removeLatestWord();
+}
+
+void ForthDictionary::removeLatestWord()
+{
+    // Remove source code entry
+    sourceCodeMap.erase(latestWord->name);
+
+    // Hand the generated code and the strings it uses back to the runtime
+    if (latestWord->compiledFunc != nullptr)
+    {
+        jc.releaseCode(reinterpret_cast<void*>(latestWord->compiledFunc));
+    }
+    if (latestWord->superseded != nullptr)
+    {
+        for (const ForthFunction old : *latestWord->superseded)
+        {
+            jc.releaseCode(reinterpret_cast<void*>(old));
+        }
+        delete latestWord->superseded;
+        latestWord->superseded = nullptr;
+    }
+
+    // The word header sits at the start of its storage, rewinding to it also
+    // recovers any data alloted after it (arrays, strings)
+    currentPos = reinterpret_cast<char*>(latestWord) - memory.data();
+
+    // Update the latest word pointer
+    latestWord = latestWord->link;
+    ++generation;
+}
+
+// Point an existing word at new code, callers compiled with indirect calls
+// load the slot on every call so they run the new code from their next call on.
+// The old code is kept while the word lives, it may be running or be called
+// directly, and is released with the word.
+void ForthDictionary::redefineWord(ForthWord* word, ForthFunction func)
+{
+    if (word->superseded == nullptr)
+    {
+        word->superseded = new std::vector<ForthFunction>();
+    }
+    word->superseded->push_back(word->compiledFunc);
+    std::atomic_ref<ForthFunction>(word->compiledFunc).store(func, std::memory_order_release);
+    jc.nameCodeRange(reinterpret_cast<void*>(func), word->name);
+    std::cout << "Redefined word " << word->name << std::endl;
+}
+
 // set the data field
 void ForthDictionary::setData(uint64_t data) const
 {
@@ -210,6 +355,7 @@ void ForthDictionary::setData(void* data) const
 void ForthDictionary::setCompiledFunction(ForthFunction func) const
 {
     latestWord->compiledFunc = func;
+    jc.nameCodeRange(reinterpret_cast<void*>(func), latestWord->name);
 }
 
 void ForthDictionary::setImmediateFunction(ForthFunction func) const
@@ -241,6 +387,7 @@ void ForthDictionary::setName(std::string name)
 {
     std::strncpy(latestWord->name, name.c_str(), sizeof(latestWord->name));
     latestWord->name[sizeof(latestWord->name) - 1] = '\0'; // Ensure null-termination
+    ++generation;
 }
 
 void ForthDictionary::setData(uint64_t d)
@@ -40,6 +40,7 @@
 #include <cstring>
 #include <vector>
 #include <cstdint>
+#include <string_view>
 #include <unordered_map>
 #include "utility.h"
 #include <variant>
@@ -180,6 +181,12 @@ private:
     }
 };
 
+// Per word flags
+enum WordFlags : uint8_t {
+    WORD_FINAL = 1 << 0, // callers may embed the code address
+    WORD_COLON = 1 << 1, // a colon definition, compiledFunc is JIT code
+};
+
 using DataVariant = std::variant<uint64_t, double, void*>;
 // Structure to represent a word in the dictionary
 struct ForthWord
@@ -191,9 +198,10 @@ struct ForthWord
     ForthFunction terpFunc; // Function pointer for the interpreter
     ForthWord* link; // Pointer to the previous word in the dictionary
     ForthWordState state; // State of the word
-    uint8_t reserved; // Reserved for future use
+    uint8_t flags; // WordFlags bits
     ForthWordType type; // Type of the word
     DataVariant data; // Holds uint64_t, double or void*
+    std::vector<ForthFunction>* superseded = nullptr; // code replaced by redefinition, released with the word
 
     // Constructor to initialize a word
     ForthWord(const char* wordName,
@@ -204,13 +212,25 @@ struct ForthWord
               ForthWord* prev = nullptr)
         : generatorFunc(genny), compiledFunc(func),
           immediateFunc(immFunc), terpFunc(terpFunc), type(WORD),
-          link(prev), state(ForthWordState::NORMAL), data(uint64_t(0)) // Default initialize to uint64_t(0)
+          link(prev), state(ForthWordState::NORMAL), flags(0), data(uint64_t(0)) // Default initialize to uint64_t(0)
     {
         std::strncpy(name, wordName, sizeof(name));
         name[sizeof(name) - 1] = '\0'; // Ensure null-termination
     }
 
 
+    // final words are always called directly, even with indirect calls on
+    bool isFinal() const { return (flags & WORD_FINAL) != 0; }
+
+    // only colon definitions can be replaced, primitives and MARKER words are not
+    // called through compiledFunc alone
+    bool isRedefinable() const
+    {
+        return (flags & WORD_COLON) != 0 && !isFinal() && generatorFunc == nullptr &&
+               immediateFunc == nullptr && terpFunc == nullptr && compiledFunc != nullptr &&
+               type == WORD && state == ForthWordState::NORMAL;
+    }
+
     // Accessor methods for data
     void setData(uint64_t value) { data = value; }
     void setData(double value) { data = value; }
@@ -272,6 +292,9 @@ public:
 
     // Find a word in the dictionary
     ForthWord* findWord(const char* name) const;
+    ForthWord* findWord(std::string_view name) const;
+    // Changes whenever a lookup could find a different word, code that bound words can check it
+    [[nodiscard]] uint64_t getGeneration() const;
 
     // Allot space in the dictionary
     void allot(size_t bytes);
@@ -287,6 +310,8 @@ public:
     // Add base words to the dictionary
     static void add_base_words();
     void forgetLastWord();
+    void forgetThrough(const ForthWord* word);
+    void redefineWord(ForthWord* word, ForthFunction func);
     void setData(uint64_t data) const;
     void setDataDouble(double data) const;
     void setData(double data) const;
@@ -311,13 +336,23 @@ public:
     // List all words in the dictionary
     void list_words() const;
 
+    // Memory accounting for *MEM
+    [[nodiscard]] size_t bytesUsed() const;
+    [[nodiscard]] size_t bytesReserved() const;
+    [[nodiscard]] size_t sourceCodeEntries() const;
+    [[nodiscard]] size_t sourceCodeBytes() const;
+
 private:
     // Private constructor to prevent instantiation
     explicit ForthDictionary(size_t size);
 
+    // Unlink the latest word, rewind its storage and release its code
+    void removeLatestWord();
+
     std::vector<char> memory; // Memory buffer for the dictionary
     size_t currentPos; // Current position in the memory buffer
     ForthWord* latestWord; // Pointer to the latest added word
+    uint64_t generation = 1; // changes whenever a lookup could give a different answer
 
     // Map to store the source code associated with each word
     std::unordered_map<std::string, std::string> sourceCodeMap;
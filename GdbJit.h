@@ -0,0 +1,219 @@
+#ifndef GDBJIT_H
+#define GDBJIT_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <elf.h>
+#endif
+
+// The GDB JIT interface, gdb breaks on the function and walks the descriptor list.
+// Names and layout are fixed by gdb, see "JIT Compilation Interface" in the gdb manual.
+extern "C" {
+typedef enum {
+    JIT_NOACTION = 0,
+    JIT_REGISTER_FN,
+    JIT_UNREGISTER_FN
+} jit_actions_t;
+
+struct jit_code_entry {
+    jit_code_entry *next_entry;
+    jit_code_entry *prev_entry;
+    const char *symfile_addr;
+    uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+    uint32_t version;
+    uint32_t action_flag;
+    jit_code_entry *relevant_entry;
+    jit_code_entry *first_entry;
+};
+
+inline __attribute__((noinline, used)) void __jit_debug_register_code() {
+    asm volatile("" ::: "memory");
+}
+
+inline jit_descriptor __jit_debug_descriptor = {1, JIT_NOACTION, nullptr, nullptr};
+}
+
+
+/**
+ * GdbJit
+ *  - Registers each named block of JIT code with gdb as a tiny in-memory ELF
+ *    holding a .text section at the code address and one function symbol.
+ *  - Backtraces and disassembly inside JIT code then show the Forth word, also
+ *    when loading a core file, so registration is on by default (FORTH_GDB_JIT=0 disables it).
+ *  - No CFI is emitted, words push rdi around every call so a single CFA rule
+ *    would be wrong exactly where a backtrace passes through them.
+ *  - Linux only, elsewhere the calls do nothing.
+ */
+class GdbJit {
+public:
+    static GdbJit &getInstance() {
+        static GdbJit instance;
+        return instance;
+    }
+
+    GdbJit(const GdbJit &) = delete;
+    GdbJit &operator=(const GdbJit &) = delete;
+
+    void registerCode(const void *start, size_t size, const std::string &name) {
+#ifdef __linux__
+        if (!enabled_) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto address = reinterpret_cast<uintptr_t>(start);
+        if (entries_.contains(address)) {
+            unregisterLocked(address);
+        }
+
+        auto &symfile = entries_[address];
+        symfile.image = buildElf(address, size, name);
+        symfile.entry.symfile_addr = symfile.image.data();
+        symfile.entry.symfile_size = symfile.image.size();
+
+        // link at the head of the list and tell the debugger
+        symfile.entry.prev_entry = nullptr;
+        symfile.entry.next_entry = __jit_debug_descriptor.first_entry;
+        if (symfile.entry.next_entry != nullptr) {
+            symfile.entry.next_entry->prev_entry = &symfile.entry;
+        }
+        __jit_debug_descriptor.first_entry = &symfile.entry;
+        __jit_debug_descriptor.relevant_entry = &symfile.entry;
+        __jit_debug_descriptor.action_flag = JIT_REGISTER_FN;
+        __jit_debug_register_code();
+#endif
+    }
+
+    void unregisterCode(const void *start) {
+#ifdef __linux__
+        if (!enabled_) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        unregisterLocked(reinterpret_cast<uintptr_t>(start));
+#endif
+    }
+
+private:
+    struct SymFile {
+        jit_code_entry entry{};
+        std::vector<char> image;
+    };
+
+    GdbJit() {
+        const char *mode = std::getenv("FORTH_GDB_JIT");
+        enabled_ = mode == nullptr || std::strcmp(mode, "0") != 0;
+    }
+
+#ifdef __linux__
+    void unregisterLocked(const uintptr_t address) {
+        const auto it = entries_.find(address);
+        if (it == entries_.end()) return;
+
+        jit_code_entry &entry = it->second.entry;
+        if (entry.prev_entry != nullptr) {
+            entry.prev_entry->next_entry = entry.next_entry;
+        } else {
+            __jit_debug_descriptor.first_entry = entry.next_entry;
+        }
+        if (entry.next_entry != nullptr) {
+            entry.next_entry->prev_entry = entry.prev_entry;
+        }
+        __jit_debug_descriptor.relevant_entry = &entry;
+        __jit_debug_descriptor.action_flag = JIT_UNREGISTER_FN;
+        __jit_debug_register_code();
+        entries_.erase(it);
+    }
+
+    // Relocatable ELF: null, .text (NOBITS at the code address), .symtab, .strtab, .shstrtab
+    static std::vector<char> buildElf(const uintptr_t address, const size_t size, const std::string &name) {
+        enum { SECT_NULL, SECT_TEXT, SECT_SYMTAB, SECT_STRTAB, SECT_SHSTRTAB, SECT_COUNT };
+
+        const std::string shstrtab = std::string("\0.text\0.symtab\0.strtab\0.shstrtab\0", 33);
+        const std::string fileName = "forth";
+        std::string strtab(1, '\0');
+        const auto fileNameOffset = static_cast<uint32_t>(strtab.size());
+        strtab += fileName + '\0';
+        const auto wordNameOffset = static_cast<uint32_t>(strtab.size());
+        strtab += name + '\0';
+
+        Elf64_Sym symbols[3]{};
+        symbols[1].st_name = fileNameOffset;
+        symbols[1].st_info = ELF64_ST_INFO(STB_LOCAL, STT_FILE);
+        symbols[1].st_shndx = SHN_ABS;
+        symbols[2].st_name = wordNameOffset;
+        symbols[2].st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symbols[2].st_shndx = SECT_TEXT;
+        symbols[2].st_value = 0; // relative to .text, which sits at the code address
+        symbols[2].st_size = size;
+
+        const size_t shoff = sizeof(Elf64_Ehdr);
+        const size_t symtabOffset = shoff + SECT_COUNT * sizeof(Elf64_Shdr);
+        const size_t strtabOffset = symtabOffset + sizeof(symbols);
+        const size_t shstrtabOffset = strtabOffset + strtab.size();
+        std::vector<char> image(shstrtabOffset + shstrtab.size());
+
+        Elf64_Ehdr header{};
+        std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+        header.e_ident[EI_CLASS] = ELFCLASS64;
+        header.e_ident[EI_DATA] = ELFDATA2LSB;
+        header.e_ident[EI_VERSION] = EV_CURRENT;
+        header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+        header.e_type = ET_REL;
+        header.e_machine = EM_X86_64;
+        header.e_version = EV_CURRENT;
+        header.e_shoff = shoff;
+        header.e_ehsize = sizeof(Elf64_Ehdr);
+        header.e_shentsize = sizeof(Elf64_Shdr);
+        header.e_shnum = SECT_COUNT;
+        header.e_shstrndx = SECT_SHSTRTAB;
+
+        Elf64_Shdr sections[SECT_COUNT]{};
+        sections[SECT_TEXT].sh_name = 1;
+        sections[SECT_TEXT].sh_type = SHT_NOBITS;
+        sections[SECT_TEXT].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+        sections[SECT_TEXT].sh_addr = address;
+        sections[SECT_TEXT].sh_size = size;
+        sections[SECT_TEXT].sh_addralign = 16;
+
+        sections[SECT_SYMTAB].sh_name = 7;
+        sections[SECT_SYMTAB].sh_type = SHT_SYMTAB;
+        sections[SECT_SYMTAB].sh_offset = symtabOffset;
+        sections[SECT_SYMTAB].sh_size = sizeof(symbols);
+        sections[SECT_SYMTAB].sh_link = SECT_STRTAB;
+        sections[SECT_SYMTAB].sh_info = 2; // first global symbol
+        sections[SECT_SYMTAB].sh_addralign = 8;
+        sections[SECT_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+
+        sections[SECT_STRTAB].sh_name = 15;
+        sections[SECT_STRTAB].sh_type = SHT_STRTAB;
+        sections[SECT_STRTAB].sh_offset = strtabOffset;
+        sections[SECT_STRTAB].sh_size = strtab.size();
+        sections[SECT_STRTAB].sh_addralign = 1;
+
+        sections[SECT_SHSTRTAB].sh_name = 23;
+        sections[SECT_SHSTRTAB].sh_type = SHT_STRTAB;
+        sections[SECT_SHSTRTAB].sh_offset = shstrtabOffset;
+        sections[SECT_SHSTRTAB].sh_size = shstrtab.size();
+        sections[SECT_SHSTRTAB].sh_addralign = 1;
+
+        std::memcpy(image.data(), &header, sizeof(header));
+        std::memcpy(image.data() + shoff, sections, sizeof(sections));
+        std::memcpy(image.data() + symtabOffset, symbols, sizeof(symbols));
+        std::memcpy(image.data() + strtabOffset, strtab.data(), strtab.size());
+        std::memcpy(image.data() + shstrtabOffset, shstrtab.data(), shstrtab.size());
+        return image;
+    }
+#endif
+
+    bool enabled_ = true;
+    std::map<uintptr_t, SymFile> entries_;
+    std::mutex mutex_;
+};
+
+#endif //GDBJIT_H
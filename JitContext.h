@@ -1,87 +1,169 @@
 #ifndef JITCONTEXT_H
 #define JITCONTEXT_H
 
+#include <algorithm>
 #include <iostream>
 #include "asmjit/asmjit.h"
 #include <string>
+#include <string_view>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "StringStorage.h"
+#include "PerfMap.h"
+#include "GdbJit.h"
+#include "WordStats.h"
+#include "CodegenStats.h"
+#include "ExecutionTrace.h"
+#include "Tokenizer.h"
 
 #define MAX_INPUT 1024
 #define MAX_WORD_LENGTH 16
-#define MAX_TOKEN_LENGTH 1024
-#define MAX_TOKENS 1024
-
-
-typedef enum {
-    TOKEN_WORD,
-    TOKEN_NUMBER,
-    TOKEN_FLOAT,
-    TOKEN_STRING,
-    TOKEN_UNKNOWN,
-    TOKEN_COMPILING,
-    TOKEN_INTERPRETING,
-    TOKEN_END
-} TokenType;
-
-typedef struct {
-    TokenType type;
-
-    union {
-        int int_value;
-        double float_value;
-        char value[1024];
-    };
-} Token;
-
-inline Token tokens[MAX_TOKENS];
-
-
-inline void print_token(const Token *token) {
-    switch (token->type) {
-        case TOKEN_WORD:
-            printf("WORD: %s\n", token->value);
-            break;
-        case TOKEN_NUMBER:
-            printf("NUMBER: %d\n", token->int_value);
-            break;
-        case TOKEN_FLOAT:
-            printf("FLOAT: %f\n", token->float_value);
-            break;
-        case TOKEN_STRING:
-            printf("STRING: \"%s\"\n", token->value);
-            break;
-        case TOKEN_COMPILING:
-            printf("COMPILING\n");
-            break;
-        case TOKEN_INTERPRETING:
-            printf("INTERPRETING\n");
-            break;
-
-        default:
-            printf("UNKNOWN\n");
-            break;
-    }
-}
-
-inline void print_token_list(const Token tokens[MAX_TOKENS]) {
-  int i = 0;
-  while (tokens[i].type != TOKEN_END && i < MAX_TOKENS) {
-    print_token(&tokens[i]);
-    i++;
-  }
-}
-
-
-static bool logging = true;
 
+
+static thread_local bool logging = true;
+
+struct ForthWord;
+
+// Where compile time goes, filled in only while enabled (see jitforth_bench --compile)
+struct CompileTimings {
+    bool enabled = false;
+    uint64_t tokenizeNs = 0;
+    uint64_t lookupNs = 0;  // dictionary lookups while compiling
+    uint64_t rtAddNs = 0;   // relocating and copying code into the runtime
+    uint64_t compileNs = 0; // whole definitions, lookup and rt.add included, tokenizing is not
+    std::vector<uint64_t> definitionNs;
+
+    void reset() {
+        tokenizeNs = lookupNs = rtAddNs = compileNs = 0;
+        definitionNs.clear();
+    }
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+// Adds the lifetime of the scope to a CompileTimings bucket when timing is enabled.
+class CompileTimer {
+public:
+    CompileTimer(const CompileTimings &timings, uint64_t &bucket)
+        : bucket_(timings.enabled ? &bucket : nullptr), start_(bucket_ ? CompileTimings::now() : 0) {
+    }
+
+    ~CompileTimer() {
+        if (bucket_) *bucket_ += CompileTimings::now() - start_;
+    }
+
+    CompileTimer(const CompileTimer &) = delete;
+    CompileTimer &operator=(const CompileTimer &) = delete;
+
+private:
+    uint64_t *bucket_;
+    uint64_t start_;
+};
+
+// Tokens pulled from a source text on demand, so nothing bounds the input and
+// only what is still in use is held: the interpreter drops each token it has run,
+// a colon definition keeps its own tokens until it is compiled.
+// Tokens view the source, which has to outlive the stream's use of it.
+class TokenStream {
+public:
+    void open(const std::string_view source, CompileTimings *timings = nullptr) {
+        cursor_ = source.data();
+        end_ = source.data() + source.size();
+        timings_ = timings;
+        base_ = 0;
+        numbers_ = true;
+        tokens_.clear();
+    }
+
+    // For scans ahead of the interpreter that only look for definitions and
+    // structure: numbers are left as words, so the scan does not depend on a
+    // BASE set by code that has not run yet, and a bad literal is reported when
+    // it is reached, not by the scan.
+    void openStructure(const std::string_view source) {
+        open(source);
+        numbers_ = false;
+    }
+
+    // Indexes count from the start of the source, past the end reads as TOKEN_END,
+    // so immediate words can look ahead freely. Returned by value, a later
+    // lookahead may move the held tokens.
+    Token operator[](const size_t index) {
+        while (index >= base_ + tokens_.size() && pull()) {
+        }
+        if (index < base_ || index >= base_ + tokens_.size()) {
+            return {};
+        }
+        return tokens_[index - base_];
+    }
+
+    // Tokens before index will not be read again.
+    void discardBefore(const size_t index) {
+        if (index <= base_) return;
+        const size_t count = std::min(index - base_, tokens_.size());
+        tokens_.erase(tokens_.begin(), tokens_.begin() + static_cast<std::ptrdiff_t>(count));
+        base_ += count;
+    }
+
+private:
+    bool pull() {
+        static CompileTimings untimed;
+        CompileTimings &timings = timings_ ? *timings_ : untimed;
+        CompileTimer timer(timings, timings.tokenizeNs);
+
+        const Token token = get_next_token(&cursor_, end_, numbers_);
+        if (token.type == TOKEN_END) {
+            return false;
+        }
+        tokens_.push_back(token);
+        if (token.type == TOKEN_WORD && cursor_ < end_ && *cursor_ == '"') {
+            tokens_.push_back(get_string_token(&cursor_, end_));
+        }
+        return true;
+    }
+
+    const char *cursor_ = "";
+    const char *end_ = cursor_;
+    CompileTimings *timings_ = nullptr;
+    size_t base_ = 0;
+    bool numbers_ = true;
+    std::vector<Token> tokens_;
+};
+
+// each compiling thread reads its own stream
+inline thread_local TokenStream tokens;
+
+
+// A block of JIT code owned by the runtime
+struct JitCodeRange {
+    uintptr_t start;
+    size_t size;
+    std::string name;
+    std::vector<const char *> strings; // interned strings the code refers to
+    size_t instructions;               // counted only with codegen stats on
+};
+
+// Each thread that compiles owns a JitContext (CodeHolder, Assembler, generator arguments).
+// The JitRuntime is shared, so code compiled on any thread is published into the same runtime.
 class JitContext {
 public:
-    // Static method to get the singleton instance
+    // Static method to get the per-thread instance
     static JitContext &getInstance() {
-        static JitContext instance;
+        static thread_local JitContext instance;
         return instance;
     }
 
+    // The runtime that owns all executable memory, shared by every context.
+    static asmjit::JitRuntime &sharedRuntime() {
+        static asmjit::JitRuntime runtime;
+        return runtime;
+    }
+
     // Delete copy constructor and assignment operator to prevent copies
     JitContext(const JitContext &) = delete;
 
@@ -100,14 +182,12 @@ public:
 
             asmjit::Section *dataSection;
             code.newSection(&dataSection, ".data", SIZE_MAX, asmjit::SectionFlags::kNone, 8);
-            // Attach the assembler to the CodeHolder
-            assembler = new asmjit::x86::Assembler(&code);
-
-            //
-            // // Recreate the assembler with the new code holder
-            // //delete assembler;
-            assembler = new asmjit::x86::Assembler(&code);
-            if (logging) {
+            // reset() detached the assembler, attach it again rather than allocating a new one
+            code.attach(assembler);
+            instructionCounter.reset();
+            if (optCodegenStats) {
+                code.setLogger(&instructionCounter);
+            } else if (logging) {
                 code.setLogger(&logger);
                 logger.addFlags(asmjit::FormatFlags::kMachineCode);
             }
@@ -141,6 +221,99 @@ public:
         }
     }
 
+    // Code registry, every function added to the runtime is recorded with its size.
+    // Shared by all contexts, as the runtime is.
+    void addCodeRange(void *start, size_t size) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        const auto address = reinterpret_cast<uintptr_t>(start);
+        codeRanges()[address] = {address, size, "", {}, optCodegenStats ? instructionCounter.count() : 0};
+        if (address < codeLowest.load(std::memory_order_relaxed)) {
+            codeLowest.store(address, std::memory_order_relaxed);
+        }
+        if (address + size > codeHighest.load(std::memory_order_relaxed)) {
+            codeHighest.store(address + size, std::memory_order_relaxed);
+        }
+    }
+
+    // Number and total size of the functions in the code registry.
+    static std::pair<size_t, size_t> codeRegistryUsage() {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        size_t bytes = 0;
+        for (const auto &[address, range]: codeRanges()) {
+            bytes += range.size;
+        }
+        return {codeRanges().size(), bytes};
+    }
+
+    // Size of the registered code starting at start, 0 if it is not registered.
+    size_t codeSizeOf(void *start) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        const auto it = codeRanges().find(reinterpret_cast<uintptr_t>(start));
+        return it == codeRanges().end() ? 0 : it->second.size;
+    }
+
+    // Name of the word whose code contains address, empty when it is not in registered code.
+    std::string codeNameAt(const uintptr_t address) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        auto it = codeRanges().upper_bound(address);
+        if (it == codeRanges().begin()) return "";
+        --it;
+        if (address >= it->first + it->second.size) return "";
+        return it->second.name.empty() ? "[anonymous]" : it->second.name;
+    }
+
+    // Bounds of all code ever registered, lock free so signal handlers can test addresses.
+    static inline std::atomic<uintptr_t> codeLowest{UINTPTR_MAX};
+    static inline std::atomic<uintptr_t> codeHighest{0};
+
+    // Attach the dictionary name once the code is owned by a word.
+    void nameCodeRange(void *start, const std::string &name) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        const auto it = codeRanges().find(reinterpret_cast<uintptr_t>(start));
+        if (it != codeRanges().end()) {
+            it->second.name = name;
+            PerfMap::getInstance().codeNamed(start, it->second.size, name);
+            GdbJit::getInstance().registerCode(start, it->second.size, name);
+            if (optCodegenStats) {
+                CodegenStats::getInstance().record(name, it->second.size, it->second.instructions);
+            }
+        }
+    }
+
+    // Interned strings whose addresses are embedded in the code.
+    void attachStrings(void *start, std::vector<const char *> strings) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        const auto it = codeRanges().find(reinterpret_cast<uintptr_t>(start));
+        if (it != codeRanges().end()) {
+            it->second.strings = std::move(strings);
+        } else {
+            GlobalStringManager::instance().release(strings);
+        }
+    }
+
+    // Queue the code for release, the word being forgotten may still be running
+    // (FORGET or a MARKER inside a word), so memory is returned at the next safe point.
+    void releaseCode(void *start) {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        if (codeRanges().contains(reinterpret_cast<uintptr_t>(start))) {
+            pendingReleases().push_back(start);
+        }
+    }
+
+    // Called when no JIT code is on the machine stack, e.g. back at the prompt.
+    void releasePendingCode() {
+        std::lock_guard<std::mutex> lock(codeRangesMutex());
+        for (void *start: pendingReleases()) {
+            const auto it = codeRanges().find(reinterpret_cast<uintptr_t>(start));
+            if (it == codeRanges().end()) continue;
+            GlobalStringManager::instance().release(it->second.strings);
+            GdbJit::getInstance().unregisterCode(start);
+            codeRanges().erase(it);
+            rt.release(start);
+        }
+        pendingReleases().clear();
+    }
+
     // Example method
     static void someJitFunction() {
         // Implementation of a method
@@ -181,9 +354,72 @@ public:
         optOverflowCheck = false;
     }
 
+    void parallelCompileON() {
+        optParallelCompile = true;
+    }
+
+    void parallelCompileOFF() {
+        optParallelCompile = false;
+    }
+
+    void indirectCallsON() {
+        optIndirectCalls = true;
+    }
+
+    void indirectCallsOFF() {
+        optIndirectCalls = false;
+    }
+
+    // count instructions of generated code and record sizes as words are named
+    void codegenStatsON() {
+        optCodegenStats = true;
+        code.setLogger(&instructionCounter);
+    }
+
+    void codegenStatsOFF() {
+        optCodegenStats = false;
+        code.setLogger(logging ? &logger : nullptr);
+    }
+
+    void wordStatsON() {
+        optWordStats = true;
+    }
+
+    void wordStatsOFF() {
+        optWordStats = false;
+    }
+
+    void traceON() {
+        optTrace = true;
+    }
+
+    void traceOFF() {
+        optTrace = false;
+    }
+
+    void autoJitON() {
+        optAutoJit = true;
+    }
+
+    void autoJitOFF() {
+        optAutoJit = false;
+    }
+
+    // worker contexts compile with the options of the thread that handed them the work
+    void copyOptionsFrom(const JitContext &other) {
+        optLoopCheck = other.optLoopCheck;
+        optOverflowCheck = other.optOverflowCheck;
+        optIndirectCalls = other.optIndirectCalls;
+        optWordStats = other.optWordStats;
+        optTrace = other.optTrace;
+        if (other.logging) loggingON(); else loggingOFF();
+        // after logging, the instruction counter takes the logger slot
+        if (other.optCodegenStats) codegenStatsON(); else codegenStatsOFF();
+    }
+
 private:
     // Private constructor to prevent instantiation
-    JitContext() : rt(),
+    JitContext() : rt(sharedRuntime()),
                    assembler(nullptr),
 
                    logger(stdout),
@@ -219,6 +455,21 @@ private:
         }
     }
 
+    static std::map<uintptr_t, JitCodeRange> &codeRanges() {
+        static std::map<uintptr_t, JitCodeRange> ranges;
+        return ranges;
+    }
+
+    static std::vector<void *> &pendingReleases() {
+        static std::vector<void *> pending;
+        return pending;
+    }
+
+    static std::mutex &codeRangesMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
     // Private destructor
     ~JitContext() {
         // Cleanup code
@@ -227,7 +478,8 @@ private:
 
 public:
     asmjit::FileLogger logger; // Logs to the standard output
-    asmjit::JitRuntime rt;
+    InstructionCounter instructionCounter;
+    asmjit::JitRuntime &rt;
     asmjit::CodeHolder code;
     asmjit::x86::Assembler *assembler;
     asmjit::Label epilogueLabel;
@@ -260,6 +512,22 @@ public:
 
     bool optLoopCheck = false;
     bool optOverflowCheck = false;
+    bool optParallelCompile = false;
+    bool optIndirectCalls = false;
+    bool optWordStats = false;
+    bool optCodegenStats = false;
+    bool optTrace = false;
+    bool optAutoJit = true; // top level control flow runs as a temporary word
+
+    // stats record of the word being compiled with optWordStats, and where its exits meet
+    WordStats *wordStats = nullptr;
+    asmjit::Label statsExitLabel;
+    uint32_t traceId = 0; // of the word being compiled, 0 when it is not traced
+
+    // the word whose new definition is being compiled, references to it call the old code
+    ForthWord *redefining = nullptr;
+
+    CompileTimings compileTimings;
     double double_A;
 
     // next token in stream
@@ -2,6 +2,7 @@
 #define JITGENERATOR_H
 
 #include <functional>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include "asmjit/asmjit.h"
@@ -20,25 +21,25 @@ static const double EPSILON = 1e-9; // Epsilon for floating-point comparison
 static const uint64_t maskAbs = 0x7FFFFFFFFFFFFFFF;
 
 
-// support locals
-static int arguments_to_local_count;
-static int locals_count;
-static int returned_arguments_count;
+// support locals, per compiling thread
+static thread_local int arguments_to_local_count;
+static thread_local int locals_count;
+static thread_local int returned_arguments_count;
 
 struct VariableInfo {
     std::string name;
     int offset;
 };
 
-static std::unordered_map<std::string, VariableInfo> arguments;
-static std::unordered_map<std::string, VariableInfo> locals;
-static std::unordered_map<std::string, VariableInfo> returnValues;
-static std::unordered_map<int, std::string> argumentsByOffset;
-static std::unordered_map<int, std::string> localsByOffset;
-static std::unordered_map<int, std::string> returnValuesByOffset;
+static thread_local std::unordered_map<std::string, VariableInfo> arguments;
+static thread_local std::unordered_map<std::string, VariableInfo> locals;
+static thread_local std::unordered_map<std::string, VariableInfo> returnValues;
+static thread_local std::unordered_map<int, std::string> argumentsByOffset;
+static thread_local std::unordered_map<int, std::string> localsByOffset;
+static thread_local std::unordered_map<int, std::string> returnValuesByOffset;
 
 
-inline JitContext &jc = JitContext::getInstance();
+inline thread_local JitContext &jc = JitContext::getInstance();
 inline ForthDictionary &d = ForthDictionary::getInstance();
 inline StackManager &sm = StackManager::getInstance();
 
@@ -473,7 +474,7 @@ public:
         if (tokens[pos].type != TOKEN_WORD) {
             throw std::runtime_error("VARIABLE: Expected word token");
         }
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         auto w = word;
         // display word w
@@ -490,7 +491,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         auto w = word;
         // This needs to be a word we can store things in.
@@ -605,7 +606,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         auto w = word;
 
@@ -668,7 +669,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         // Extract the first character from the word
         char charValue = word.front();
@@ -695,7 +696,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         jc.pos_last_word = pos;
 
@@ -723,7 +724,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         // Pop the array size from the data stack
         auto arraySize = sm.popDS();
@@ -783,7 +784,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
 
         // Pop the initial value from the data stack
@@ -811,6 +812,43 @@ public:
     }
 
 
+    static void prim_marker(const ForthWord *marker) {
+        d.forgetThrough(marker);
+    }
+
+    // MARKER --tidy
+    // creates a word that forgets itself and every word defined after it,
+    // releasing their code and strings
+    static void genImmediateMarker() {
+        size_t pos = jc.pos_next_word + 1;
+        if (tokens[pos].type != TOKEN_WORD) {
+            throw std::runtime_error("MARKER: Expected word token");
+        }
+
+        std::string word = tokens[pos].str();
+        jc.word = word;
+
+        jc.resetContext();
+        if (!jc.assembler) {
+            throw std::runtime_error("entryFunction: Assembler not initialized");
+        }
+        auto &a = *jc.assembler;
+        commentWithWord(" ; ----- marker: ", word);
+        d.addWord(word.c_str(), nullptr, nullptr, nullptr, nullptr);
+        const ForthWord *marker = d.getLatestWord();
+
+        a.push(asmjit::x86::rdi);
+        a.mov(asmjit::x86::rdi, asmjit::imm(reinterpret_cast<uint64_t>(marker)));
+        a.call(asmjit::imm(reinterpret_cast<void *>(prim_marker)));
+        a.pop(asmjit::x86::rdi);
+        a.ret();
+
+        ForthFunction compiledFunc = endGeneration();
+        d.setCompiledFunction(compiledFunc);
+        jc.pos_last_word = pos;
+    }
+
+
     // immediate value, runs when value is called.
     // 10.0 FVALUE fred
     static void genImmediateFvalue() {
@@ -819,7 +857,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
 
         // Pop the initial value from the data stack
@@ -856,7 +894,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
         // Pop the initial value from the data stack
         auto initialValue = sm.popDS();
@@ -890,7 +928,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
 
         // Pop the initial value from the data stack
@@ -936,7 +974,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
 
 
@@ -952,7 +990,7 @@ public:
             throw std::runtime_error("VARIABLE: Expected word token");
         }
 
-        std::string word = tokens[pos].value;
+        std::string word = tokens[pos].str();
         jc.word = word;
 
         jc.resetContext();
@@ -1026,6 +1064,15 @@ public:
         funcLabels.exitLabel = a.newLabel();
         a.bind(funcLabels.entryLabel);
 
+        // after the entry label, so RECURSE is counted too
+        jc.traceId = 0;
+        if (jc.optTrace) {
+            genTraceEntry();
+        }
+        jc.wordStats = nullptr;
+        if (jc.optWordStats) {
+            genStatsEntry();
+        }
 
         // Save on loopStack
         const LoopLabel loopLabel{LoopType::FUNCTION_ENTRY_EXIT, funcLabels};
@@ -1091,12 +1138,72 @@ public:
             arguments_to_local_count = locals_count = returned_arguments_count = 0;
         }
 
+        if (jc.wordStats) {
+            genStatsExit();
+        }
+
         exitFunction();
         // Free the total stack space on the return stack pointer.
         a.ret();
     }
 
 
+    // Count the call and keep the entry time stamp in a 16 byte slot on the machine stack,
+    // 16 so calls made by the word stay aligned.
+    static void genStatsEntry() {
+        auto &a = *jc.assembler;
+        jc.wordStats = WordStatsTable::getInstance().allocate();
+        jc.statsExitLabel = a.newLabel();
+
+        a.comment(" ; ----- word stats entry");
+        a.sub(asmjit::x86::rsp, 16);
+        a.mov(asmjit::x86::rax, asmjit::imm(reinterpret_cast<uint64_t>(jc.wordStats)));
+        a.inc(asmjit::x86::qword_ptr(asmjit::x86::rax, offsetof(WordStats, calls)));
+        a.rdtsc();
+        a.shl(asmjit::x86::rdx, 32);
+        a.or_(asmjit::x86::rax, asmjit::x86::rdx);
+        a.mov(asmjit::x86::qword_ptr(asmjit::x86::rsp), asmjit::x86::rax);
+    }
+
+    // Add the elapsed ticks and drop the slot, EXIT jumps here as well.
+    static void genStatsExit() {
+        auto &a = *jc.assembler;
+        a.bind(jc.statsExitLabel);
+        a.comment(" ; ----- word stats exit");
+        a.rdtsc();
+        a.shl(asmjit::x86::rdx, 32);
+        a.or_(asmjit::x86::rax, asmjit::x86::rdx);
+        a.sub(asmjit::x86::rax, asmjit::x86::qword_ptr(asmjit::x86::rsp));
+        a.mov(asmjit::x86::rdx, asmjit::imm(reinterpret_cast<uint64_t>(jc.wordStats)));
+        a.add(asmjit::x86::qword_ptr(asmjit::x86::rdx, offsetof(WordStats, cycles)), asmjit::x86::rax);
+        a.add(asmjit::x86::rsp, 16);
+    }
+
+    // Append (DS depth << 32 | word id) to the trace ring, the name is set once it is known.
+    static void genTraceEntry() {
+        auto &a = *jc.assembler;
+        ExecutionTrace &trace = ExecutionTrace::getInstance();
+        jc.traceId = trace.allocateId();
+
+        a.comment(" ; ----- trace entry");
+        a.mov(asmjit::x86::rax, asmjit::imm(sm.getDStop()));
+        a.sub(asmjit::x86::rax, asmjit::x86::r15);
+        a.sar(asmjit::x86::rax, 3);
+        a.shl(asmjit::x86::rax, 32);
+        a.or_(asmjit::x86::rax, asmjit::imm(jc.traceId));
+        a.mov(asmjit::x86::rcx, asmjit::imm(reinterpret_cast<uint64_t>(trace.ring())));
+        a.mov(asmjit::x86::rdx, asmjit::x86::qword_ptr(asmjit::x86::rcx, offsetof(TraceRing, next)));
+        a.inc(asmjit::x86::qword_ptr(asmjit::x86::rcx, offsetof(TraceRing, next)));
+        a.and_(asmjit::x86::edx, asmjit::imm(TraceRing::SIZE - 1));
+        a.mov(asmjit::x86::qword_ptr(asmjit::x86::rcx, asmjit::x86::rdx, 3, offsetof(TraceRing, entries)),
+              asmjit::x86::rax);
+    }
+
+    static void dotStats() {
+        WordStatsTable::getInstance().display();
+    }
+
+
     // exit jump off the word.
     // needs to pop values from the return stack.
 
@@ -1112,6 +1219,10 @@ public:
         bool found = false;
         auto drop_bytes = 8 * doLoopDepth;
         a.add(asmjit::x86::r14, drop_bytes);
+        if (jc.wordStats) {
+            a.jmp(jc.statsExitLabel); // account the time before returning
+            return;
+        }
         a.ret(); // return early from function.
     }
 
@@ -1262,6 +1373,32 @@ public:
     }
 
 
+    // BASE ( -- addr ) the radix the tokenizer reads integer literals in
+    static void genBase() {
+        jc.uint64_A = reinterpret_cast<uint64_t>(&numberBase);
+        genPushLong();
+    }
+
+    static void genSetBase(const int32_t base) {
+        if (!jc.assembler) {
+            throw std::runtime_error("gen_set_base: Assembler not initialized");
+        }
+
+        auto &a = *jc.assembler;
+        a.comment(" ; ----- set BASE");
+        a.mov(asmjit::x86::rax, asmjit::imm(reinterpret_cast<uint64_t>(&numberBase)));
+        a.mov(asmjit::x86::qword_ptr(asmjit::x86::rax), base);
+    }
+
+    static void genHex() {
+        genSetBase(16);
+    }
+
+    static void genDecimal() {
+        genSetBase(10);
+    }
+
+
     static void genPushDouble() {
         if (!jc.assembler) {
             throw std::runtime_error("gen_push_long: Assembler not initialized");
@@ -1319,9 +1456,11 @@ public:
         }
         // Finalize the function
         ForthFunction func;
+        CompileTimer timer(jc.compileTimings, jc.compileTimings.rtAddNs);
         if (const asmjit::Error err = jc.rt.add(&func, &jc.code)) {
             throw std::runtime_error(asmjit::DebugUtils::errorAsString(err));
         }
+        jc.addCodeRange(reinterpret_cast<void *>(func), jc.code.codeSize());
 
         return func;
     }
@@ -1366,6 +1505,35 @@ public:
         a.pop(asmjit::x86::rdi);
     }
 
+    // Call a dictionary word. With indirect calls on, the call loads the word's
+    // compiledFunc slot so a later redefinition reaches this caller.
+    // Final words, and the word being redefined (its old code), are called directly.
+    static void genCallWord(ForthWord *word) {
+        if (!jc.optIndirectCalls || word->isFinal() || word == jc.redefining) {
+            genCall(word->compiledFunc);
+            return;
+        }
+        if (!jc.assembler) {
+            throw std::runtime_error("gen_call: Assembler not initialized");
+        }
+        auto &a = *jc.assembler;
+
+        commentWithWord(" ; ----- gen_call indirect ", word->name);
+        a.mov(asmjit::x86::rax, asmjit::imm(reinterpret_cast<uint64_t>(&word->compiledFunc)));
+        a.push(asmjit::x86::rdi);
+        a.call(asmjit::x86::qword_ptr(asmjit::x86::rax));
+        a.pop(asmjit::x86::rdi);
+    }
+
+    // FINAL marks the latest word, callers compiled after it embed its address
+    static void markFinal() {
+        ForthWord *word = d.getLatestWord();
+        if (word == nullptr) {
+            throw std::runtime_error("FINAL: no word to mark");
+        }
+        word->flags |= WORD_FINAL;
+    }
+
     // Executable function pointer
 
 
@@ -3945,7 +4113,7 @@ shiftAction(shiftAmount);                    \
     static void doDotQuote() {
         jc.pos_next_word++;
         if (Token t = tokens[jc.pos_next_word]; t.type == TOKEN_STRING) {
-            putchars(t.value);
+            fwrite(t.text, 1, t.length, stdout);
         }
 
     }
@@ -3958,7 +4126,7 @@ shiftAction(shiftAmount);                    \
             throw std::runtime_error("s.: Expected string token");
         }
         GlobalStringManager& gsm = GlobalStringManager::instance();
-        GlobalString gs = gsm.create(jc.next_token.value);
+        GlobalString gs = gsm.create(jc.next_token.str());
         const char* internedPtr = gs.c_str();
         sm.pushDS(reinterpret_cast<u_int64_t>(internedPtr));
         jc.pos_last_word = pos;
@@ -3978,7 +4146,7 @@ shiftAction(shiftAmount);                    \
         if (tokens[pos].type != TOKEN_STRING) {
             throw std::runtime_error("s.: Expected string token");
         }
-        std::string text = tokens[pos].value;
+        std::string text = tokens[pos].str();
         GlobalStringManager& gsm = GlobalStringManager::instance();
         GlobalString gs = gsm.create(text);
         const char* internedPtr = gs.c_str();
@@ -4001,7 +4169,7 @@ shiftAction(shiftAmount);                    \
         if (tokens[pos].type != TOKEN_STRING) {
             throw std::runtime_error("s.: Expected string token");
         }
-        std::string text = tokens[pos].value;
+        std::string text = tokens[pos].str();
         GlobalStringManager& gsm = GlobalStringManager::instance();
         GlobalString gs = gsm.create(text);
         const char* internedPtr = gs.c_str();
@@ -4011,6 +4179,25 @@ shiftAction(shiftAmount);                    \
         jc.pos_last_word = pos;
     }
 
+    // ZCOUNT ( zaddr -- zaddr len ) length of a NUL terminated string such as s" leaves
+    static void prim_zcount() {
+        const uint64_t address = sm.popDS();
+        sm.pushDS(address);
+        sm.pushDS(std::strlen(reinterpret_cast<const char *>(address)));
+    }
+
+    static void genZCount() {
+        if (!jc.assembler) {
+            throw std::runtime_error("gen_zcount: Assembler not initialized");
+        }
+
+        auto &a = *jc.assembler;
+        a.comment(" ; ----- zcount");
+        a.push(asmjit::x86::rdi);
+        a.call(asmjit::imm(reinterpret_cast<void *>(prim_zcount)));
+        a.pop(asmjit::x86::rdi);
+    }
+
     // supports sprint
     static void genPrint()
     {
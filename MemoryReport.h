@@ -0,0 +1,83 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "ForthDictionary.h"
+#include "JitContext.h"
+#include "StackManager.h"
+#include "StringStorage.h"
+
+// Resident set size in bytes: /proc/self/statm on Linux, the peak from getrusage elsewhere.
+inline size_t processResidentBytes() {
+#ifdef __linux__
+    if (FILE *statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long size = 0;
+        unsigned long resident = 0;
+        const int fields = std::fscanf(statm, "%lu %lu", &size, &resident);
+        std::fclose(statm);
+        if (fields == 2) return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+}
+
+// *MEM, where the memory of the process goes: used versus reserved, in KiB.
+inline void reportMemory() {
+    auto kib = [](const size_t bytes) { return (bytes + 1023) / 1024; };
+    auto row = [&](const std::string &what, const size_t used, const size_t reserved, const std::string &note = "") {
+        std::cout << "  " << std::left << std::setw(24) << what << std::right
+                << std::setw(12) << kib(used) << std::setw(12) << kib(reserved);
+        if (!note.empty()) std::cout << "  " << note;
+        std::cout << "\n";
+    };
+
+    std::cout << "Memory (KiB)" << std::string(22, ' ') << "used    reserved\n";
+
+    JitContext &context = JitContext::getInstance();
+    const auto allocator = context.rt.allocator()->statistics();
+    const auto [functions, codeBytes] = JitContext::codeRegistryUsage();
+    row("JIT code", allocator.usedSize(), allocator.reservedSize(),
+        std::to_string(allocator.blockCount()) + " blocks, " + std::to_string(kib(allocator.overheadSize())) +
+        " KiB allocator overhead");
+    row("  registered functions", codeBytes, codeBytes, std::to_string(functions) + " functions");
+
+    const ForthDictionary &dictionary = ForthDictionary::getInstance();
+    row("dictionary", dictionary.bytesUsed(), dictionary.bytesReserved());
+    row("source code map", dictionary.sourceCodeBytes(), dictionary.sourceCodeBytes(),
+        std::to_string(dictionary.sourceCodeEntries()) + " entries");
+
+    const StringUsage global = GlobalStringManager::instance().usage();
+    const StringUsage transient = TransientStringManager::instance().usage();
+    row("global strings", global.bytes, global.bytes, std::to_string(global.strings) + " strings");
+    row("transient strings", transient.bytes, transient.bytes, std::to_string(transient.strings) + " strings");
+
+    const StackManager &stacks = StackManager::getInstance();
+    const auto capacity = stacks.capacity();
+    const auto resident = stacks.residentCells();
+    const auto peak = stacks.highWater();
+    auto stackRow = [&](const std::string &name, const uint64_t residentCells, const uint64_t cells,
+                        const uint64_t peakCells) {
+        row(name + " stack (resident)", residentCells * sizeof(uint64_t), cells * sizeof(uint64_t),
+            "max depth " + std::to_string(peakCells) + " cells");
+    };
+    stackRow("DS", resident.ds, capacity.ds, peak.ds);
+    stackRow("RS", resident.rs, capacity.rs, peak.rs);
+    stackRow("LS", resident.ls, capacity.ls, peak.ls);
+    stackRow("SS", resident.ss, capacity.ss, peak.ss);
+
+    std::cout << "  " << std::left << std::setw(24) << "process RSS" << std::right
+            << std::setw(12) << kib(processResidentBytes()) << std::endl;
+}
+
+#endif //MEMORYREPORT_H
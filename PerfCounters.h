@@ -0,0 +1,169 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ForthDictionary.h"
+#include "StackManager.h"
+#include "CompilerUtility.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * PerfCounters
+ *  - *PERF word n runs a word n times under one perf_event_open group:
+ *    cycles, instructions, branch misses, L1D read misses and LLC misses.
+ *  - The stacks are reset through StackManager before every run with the
+ *    counters stopped, so words with a net stack effect can be measured and
+ *    the reset is not counted. The counters are enabled only around the call.
+ *  - Events the machine (or VM) does not provide are left out of the group.
+ *  - Linux only, other platforms report that counters are unavailable.
+ */
+class PerfCounters {
+public:
+    static void measureWord(const std::string &name, const uint64_t iterations) {
+        ForthWord *word = ForthDictionary::getInstance().findWord(name.c_str());
+        if (word == nullptr || word->compiledFunc == nullptr) {
+            std::cerr << "*PERF: no compiled word " << name << std::endl;
+            return;
+        }
+        if (iterations == 0) {
+            std::cerr << "*PERF: iteration count must be positive" << std::endl;
+            return;
+        }
+#ifdef __linux__
+        Group group;
+        if (!group.open()) {
+            std::cerr << "*PERF: perf_event_open failed: " << std::strerror(errno)
+                    << " (check /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+            return;
+        }
+
+        ioctl(group.leader(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            resetStacks(); // counters are stopped here
+            ioctl(group.leader(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            exec(word->compiledFunc);
+            ioctl(group.leader(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+        resetStacks();
+
+        group.report(name, iterations);
+#else
+        std::cerr << "*PERF: hardware counters need Linux perf_event_open" << std::endl;
+#endif
+    }
+
+private:
+    static void resetStacks() {
+        StackManager &stacks = StackManager::getInstance();
+        stacks.resetDS();
+        stacks.resetRS();
+        stacks.resetLS();
+        stacks.resetSS();
+    }
+
+#ifdef __linux__
+    struct Event {
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+        int fd = -1;
+    };
+
+    class Group {
+    public:
+        Group() = default;
+        Group(const Group &) = delete;
+        Group &operator=(const Group &) = delete;
+
+        ~Group() {
+            for (auto &event: events_) {
+                if (event.fd >= 0) close(event.fd);
+            }
+        }
+
+        // the leader (cycles) has to open, the others are optional
+        bool open() {
+            for (auto &event: events_) {
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = event.type;
+                attr.config = event.config;
+                attr.disabled = &event == &events_.front();
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+                const int groupFd = &event == &events_.front() ? -1 : leader();
+                event.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+                if (&event == &events_.front() && event.fd < 0) return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] int leader() const {
+            return events_.front().fd;
+        }
+
+        void report(const std::string &name, const uint64_t iterations) const {
+            // group read: nr, time_enabled, time_running, then one value per open event
+            std::vector<uint64_t> values(3 + events_.size());
+            if (read(leader(), values.data(), values.size() * sizeof(uint64_t)) <= 0) {
+                std::cerr << "*PERF: reading counters failed" << std::endl;
+                return;
+            }
+            const uint64_t enabled = values[1];
+            const uint64_t running = values[2];
+            const double scale = running > 0 ? static_cast<double>(enabled) / running : 1.0;
+
+            std::cout << "*PERF " << name << " x " << iterations << " (per iteration)" << std::endl;
+            double cycles = 0;
+            double instructions = 0;
+            size_t slot = 3;
+            for (const auto &event: events_) {
+                if (event.fd < 0) {
+                    std::cout << "  " << std::left << std::setw(16) << event.name << "not supported" << std::endl;
+                    continue;
+                }
+                const double perIteration = values[slot++] * scale / iterations;
+                if (event.config == PERF_COUNT_HW_CPU_CYCLES && event.type == PERF_TYPE_HARDWARE) cycles = perIteration;
+                if (event.config == PERF_COUNT_HW_INSTRUCTIONS && event.type == PERF_TYPE_HARDWARE) instructions = perIteration;
+                std::cout << "  " << std::left << std::setw(16) << event.name << std::right
+                        << std::fixed << std::setprecision(1) << std::setw(14) << perIteration << std::endl;
+            }
+            if (cycles > 0) {
+                std::cout << "  " << std::left << std::setw(16) << "IPC" << std::right
+                        << std::fixed << std::setprecision(2) << std::setw(14) << instructions / cycles << std::endl;
+            }
+            if (scale > 1.0) {
+                std::cout << "  (counters multiplexed, scaled by " << std::setprecision(2) << scale << ")" << std::endl;
+            }
+        }
+
+    private:
+        std::vector<Event> events_{
+            {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {
+                "L1D-read-misses", PERF_TYPE_HW_CACHE,
+                PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+            },
+            {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        };
+    };
+#endif
+};
+
+#endif //PERFCOUNTERS_H
@@ -0,0 +1,178 @@
+#ifndef PERFMAP_H
+#define PERFMAP_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * PerfMap
+ *  - Tells Linux perf where JIT code lives, so samples resolve to Forth words.
+ *  - FORTH_PERF_MAP=1        writes /tmp/perf-<pid>.map (address size name per line)
+ *  - FORTH_PERF_MAP=jitdump  also writes /tmp/jit-<pid>.dump with the code bytes,
+ *    record with `perf record -k mono` and run `perf inject --jit` for annotate.
+ *  - Entries are written when a word (or primitive) is given its code.
+ *  - Does nothing on other platforms.
+ */
+class PerfMap {
+public:
+    static PerfMap &getInstance() {
+        static PerfMap instance;
+        return instance;
+    }
+
+    PerfMap(const PerfMap &) = delete;
+    PerfMap &operator=(const PerfMap &) = delete;
+
+    [[nodiscard]] bool enabled() const {
+        return mapFile_ != nullptr;
+    }
+
+    // Record that [start, start+size) now holds the code of the named word.
+    void codeNamed(const void *start, size_t size, const std::string &name) {
+#ifdef __linux__
+        if (mapFile_ == nullptr) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::fprintf(mapFile_, "%lx %zx %s\n", reinterpret_cast<unsigned long>(start), size, name.c_str());
+        std::fflush(mapFile_);
+        if (dumpFd_ >= 0) {
+            writeCodeLoad(start, size, name);
+        }
+#endif
+    }
+
+private:
+#ifdef __linux__
+    // jitdump format, see tools/perf/Documentation/jitdump-specification.txt
+    static constexpr uint32_t JITDUMP_MAGIC = 0x4A695444;
+    static constexpr uint32_t JITDUMP_VERSION = 1;
+    static constexpr uint32_t JIT_CODE_LOAD = 0;
+    static constexpr uint32_t JIT_CODE_CLOSE = 3;
+    static constexpr uint32_t EM_X86_64_MACHINE = 62;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t total_size;
+        uint32_t elf_mach;
+        uint32_t pad1;
+        uint32_t pid;
+        uint64_t timestamp;
+        uint64_t flags;
+    };
+
+    struct RecordHeader {
+        uint32_t id;
+        uint32_t total_size;
+        uint64_t timestamp;
+    };
+
+    struct CodeLoad {
+        RecordHeader header;
+        uint32_t pid;
+        uint32_t tid;
+        uint64_t vma;
+        uint64_t code_addr;
+        uint64_t code_size;
+        uint64_t code_index;
+        // followed by the name and the code bytes
+    };
+
+    // perf matches jitdump records against samples on CLOCK_MONOTONIC
+    static uint64_t timestamp() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+
+    void openJitDump() {
+        const std::string path = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+        dumpFd_ = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (dumpFd_ < 0) return;
+
+        // perf finds the dump through this executable mapping of the file
+        marker_ = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, dumpFd_, 0);
+        if (marker_ == MAP_FAILED) {
+            marker_ = nullptr;
+        }
+
+        const FileHeader header{
+            JITDUMP_MAGIC, JITDUMP_VERSION, sizeof(FileHeader), EM_X86_64_MACHINE, 0,
+            static_cast<uint32_t>(getpid()), timestamp(), 0
+        };
+        writeAll(&header, sizeof(header));
+    }
+
+    void writeCodeLoad(const void *start, size_t size, const std::string &name) {
+        CodeLoad record{};
+        record.header.id = JIT_CODE_LOAD;
+        record.header.total_size = static_cast<uint32_t>(sizeof(CodeLoad) + name.size() + 1 + size);
+        record.header.timestamp = timestamp();
+        record.pid = static_cast<uint32_t>(getpid());
+        record.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+        record.vma = reinterpret_cast<uint64_t>(start);
+        record.code_addr = record.vma;
+        record.code_size = size;
+        record.code_index = codeIndex_++;
+
+        writeAll(&record, sizeof(record));
+        writeAll(name.c_str(), name.size() + 1);
+        writeAll(start, size);
+    }
+
+    void writeAll(const void *data, size_t size) const {
+        auto *p = static_cast<const char *>(data);
+        while (size > 0) {
+            const ssize_t n = write(dumpFd_, p, size);
+            if (n <= 0) return;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+#endif
+
+    PerfMap() {
+#ifdef __linux__
+        const char *mode = std::getenv("FORTH_PERF_MAP");
+        if (mode == nullptr || *mode == '\0' || std::strcmp(mode, "0") == 0) return;
+
+        const std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+        mapFile_ = std::fopen(path.c_str(), "w");
+        if (mapFile_ != nullptr && std::strcmp(mode, "jitdump") == 0) {
+            openJitDump();
+        }
+#endif
+    }
+
+    ~PerfMap() {
+#ifdef __linux__
+        if (dumpFd_ >= 0) {
+            const RecordHeader close{JIT_CODE_CLOSE, sizeof(RecordHeader), timestamp()};
+            writeAll(&close, sizeof(close));
+            if (marker_ != nullptr) munmap(marker_, sysconf(_SC_PAGESIZE));
+            ::close(dumpFd_);
+        }
+        if (mapFile_ != nullptr) std::fclose(mapFile_);
+#endif
+    }
+
+    std::FILE *mapFile_ = nullptr;
+    int dumpFd_ = -1;
+    void *marker_ = nullptr;
+    uint64_t codeIndex_ = 0;
+    std::mutex mutex_;
+};
+
+#endif //PERFMAP_H
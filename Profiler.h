@@ -0,0 +1,232 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <pthread.h>
+#include <string>
+#include <sys/time.h>
+#include <vector>
+#include "JitContext.h"
+#ifdef __APPLE__
+#include <sys/ucontext.h> // <ucontext.h> requires _XOPEN_SOURCE on macOS
+#else
+#include <ucontext.h>
+#endif
+
+/**
+ * Profiler
+ *  - *PROFILE ON starts a SIGPROF timer (1ms of CPU time per sample).
+ *  - The handler records the interrupted PC and scans the machine stack above
+ *    the interrupted rsp for return addresses inside JIT code. JIT words keep
+ *    no frame pointer, so the scan is conservative: a stale JIT address left in a
+ *    dead stack slot can show up as an extra caller.
+ *  - Samples go into a buffer allocated up front, the handler takes no locks.
+ *  - *PROFILE REPORT resolves addresses through the code registry, prints the
+ *    top words by self and total samples and writes folded stacks for flamegraph.pl.
+ *  - Only the thread that turned profiling on is sampled.
+ */
+class Profiler {
+public:
+    static Profiler &getInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    void start() {
+        if (running_) return;
+
+        samples_.assign(MAX_SAMPLES, Sample{});
+        sampleCount_.store(0, std::memory_order_relaxed);
+        captureStackBounds();
+        sampledThread_ = pthread_self();
+        samplesPtr_ = samples_.data();
+
+        struct sigaction action{};
+        action.sa_sigaction = onSample;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, &previousAction_);
+
+        itimerval timer{};
+        timer.it_interval.tv_usec = SAMPLE_INTERVAL_US;
+        timer.it_value.tv_usec = SAMPLE_INTERVAL_US;
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        running_ = true;
+    }
+
+    void stop() {
+        if (!running_) return;
+        itimerval timer{};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        sigaction(SIGPROF, &previousAction_, nullptr);
+        running_ = false;
+    }
+
+    void report(const size_t topN = 20, const std::string &foldedPath = "profile.folded") {
+        const size_t count = std::min(sampleCount_.load(std::memory_order_acquire), MAX_SAMPLES);
+        if (count == 0) {
+            std::cout << "No samples, run some code with *PROFILE ON" << std::endl;
+            return;
+        }
+
+        JitContext &context = JitContext::getInstance();
+        std::map<uintptr_t, std::string> names; // address -> word, resolved once
+        auto resolve = [&](const uintptr_t address) -> const std::string & {
+            auto it = names.find(address);
+            if (it == names.end()) {
+                it = names.emplace(address, context.codeNameAt(address)).first;
+            }
+            return it->second;
+        };
+
+        std::map<std::string, size_t> self;
+        std::map<std::string, size_t> total;
+        std::map<std::string, size_t> folded;
+        for (size_t i = 0; i < count; ++i) {
+            const Sample &sample = samples_[i];
+
+            // leaf first, skip addresses outside any word and repeats of the same word
+            std::vector<std::string> stack;
+            for (uint32_t f = 0; f < sample.depth; ++f) {
+                const std::string &name = resolve(sample.frames[f]);
+                if (name.empty()) continue;
+                if (stack.empty() || stack.back() != name) stack.push_back(name);
+            }
+
+            const std::string leaf = sample.inJit && !stack.empty() ? stack.front() : "[native]";
+            ++self[leaf];
+            std::vector<std::string> seen;
+            for (const auto &name: stack) {
+                if (std::ranges::find(seen, name) != seen.end()) continue;
+                seen.push_back(name);
+                ++total[name];
+            }
+
+            std::string line;
+            for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+                if (!line.empty()) line += ';';
+                line += *it;
+            }
+            if (!sample.inJit) line += line.empty() ? "[native]" : ";[native]";
+            ++folded[line];
+        }
+
+        std::vector<std::pair<std::string, size_t> > ranked(self.begin(), self.end());
+        std::ranges::sort(ranked, [](const auto &a, const auto &b) { return a.second > b.second; });
+
+        std::cout << "Samples: " << count;
+        if (sampleCount_.load() > MAX_SAMPLES) std::cout << " (buffer full, " << sampleCount_.load() << " taken)";
+        std::cout << "\n" << std::left << std::setw(32) << "word"
+                << std::right << std::setw(10) << "self" << std::setw(9) << "self%"
+                << std::setw(10) << "total" << "\n";
+        for (size_t i = 0; i < ranked.size() && i < topN; ++i) {
+            const auto &[name, samples] = ranked[i];
+            std::cout << std::left << std::setw(32) << name
+                    << std::right << std::setw(10) << samples
+                    << std::setw(8) << std::fixed << std::setprecision(1) << 100.0 * samples / count << "%"
+                    << std::setw(10) << total[name] << "\n";
+        }
+
+        std::ofstream out(foldedPath);
+        for (const auto &[line, samples]: folded) {
+            out << line << ' ' << samples << '\n';
+        }
+        std::cout << "Folded stacks written to " << foldedPath << std::endl;
+    }
+
+    [[nodiscard]] bool running() const {
+        return running_;
+    }
+
+private:
+    static constexpr size_t MAX_SAMPLES = 1 << 16;
+    static constexpr uint32_t MAX_FRAMES = 64;
+    static constexpr size_t MAX_SCAN_WORDS = 1024;
+    static constexpr long SAMPLE_INTERVAL_US = 1000;
+
+    struct Sample {
+        uint32_t depth;
+        bool inJit;
+        uintptr_t frames[MAX_FRAMES];
+    };
+
+    Profiler() = default;
+
+    ~Profiler() {
+        stop();
+    }
+
+    void captureStackBounds() {
+#ifdef __APPLE__
+        stackHigh_ = reinterpret_cast<uintptr_t>(pthread_get_stackaddr_np(pthread_self()));
+#else
+        pthread_attr_t attr;
+        void *address = nullptr;
+        size_t size = 0;
+        pthread_getattr_np(pthread_self(), &attr);
+        pthread_attr_getstack(&attr, &address, &size);
+        pthread_attr_destroy(&attr);
+        stackHigh_ = reinterpret_cast<uintptr_t>(address) + size;
+#endif
+    }
+
+    static bool isJit(const uintptr_t address) {
+        return address >= JitContext::codeLowest.load(std::memory_order_relaxed) &&
+               address < JitContext::codeHighest.load(std::memory_order_relaxed);
+    }
+
+    // async-signal context: no allocation, no locks
+    static void onSample(int, siginfo_t *, void *context) {
+        if (!pthread_equal(pthread_self(), sampledThread_)) return;
+        const size_t index = sampleCount_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= MAX_SAMPLES) return;
+
+        const auto *uc = static_cast<ucontext_t *>(context);
+#ifdef __APPLE__
+        const auto pc = static_cast<uintptr_t>(uc->uc_mcontext->__ss.__rip);
+        const auto sp = static_cast<uintptr_t>(uc->uc_mcontext->__ss.__rsp);
+#else
+        const auto pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+        const auto sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+#endif
+
+        Sample &sample = samplesPtr_[index];
+        sample.depth = 0;
+        sample.inJit = isJit(pc);
+        if (sample.inJit) {
+            sample.frames[sample.depth++] = pc;
+        }
+
+        const uintptr_t end = std::min(stackHigh_, sp + MAX_SCAN_WORDS * sizeof(uintptr_t));
+        for (uintptr_t slot = sp; slot + sizeof(uintptr_t) <= end && sample.depth < MAX_FRAMES;
+             slot += sizeof(uintptr_t)) {
+            const uintptr_t value = *reinterpret_cast<const uintptr_t *>(slot);
+            if (isJit(value)) {
+                sample.frames[sample.depth++] = value;
+            }
+        }
+        std::atomic_signal_fence(std::memory_order_release);
+    }
+
+    std::vector<Sample> samples_;
+    bool running_ = false;
+    struct sigaction previousAction_{};
+
+    // read by the signal handler
+    static inline Sample *samplesPtr_ = nullptr;
+    static inline std::atomic<size_t> sampleCount_{0};
+    static inline uintptr_t stackHigh_ = 0;
+    static inline pthread_t sampledThread_{};
+};
+
+#endif //PROFILER_H
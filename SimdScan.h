@@ -0,0 +1,107 @@
+#ifndef SIMDSCAN_H
+#define SIMDSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Byte scans for the tokenizer, 32 bytes a step with AVX2, 16 with SSE2 (every
+// x86-64 build), one at a time elsewhere and for the tail. Blocks are only loaded
+// while they lie wholly before end, so a mapped file is never read past its end.
+// Whitespace is the C locale isspace set, a NUL also stops every scan.
+
+namespace simd_scan {
+    inline bool is_space(const char c) {
+        return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+    }
+
+#if defined(__AVX2__)
+    constexpr ptrdiff_t WIDTH = 32;
+    using Block = __m256i;
+
+    inline Block load(const char *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+
+    inline uint32_t equal_mask(const Block v, const char c) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+    }
+
+    inline uint32_t space_mask(const Block v) {
+        // \t..\r as an unsigned range check, min(x, 4) == x
+        const Block control = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+        const Block inRange = _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8('\r' - '\t')), control);
+        return static_cast<uint32_t>(_mm256_movemask_epi8(inRange)) | equal_mask(v, ' ');
+    }
+
+    constexpr uint32_t ALL = 0xffffffffu;
+#elif defined(__SSE2__)
+    constexpr ptrdiff_t WIDTH = 16;
+    using Block = __m128i;
+
+    inline Block load(const char *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+
+    inline uint32_t equal_mask(const Block v, const char c) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+    }
+
+    inline uint32_t space_mask(const Block v) {
+        // \t..\r as an unsigned range check, min(x, 4) == x
+        const Block control = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+        const Block inRange = _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8('\r' - '\t')), control);
+        return static_cast<uint32_t>(_mm_movemask_epi8(inRange)) | equal_mask(v, ' ');
+    }
+
+    constexpr uint32_t ALL = 0xffffu;
+#endif
+}
+
+// First byte at or after p that is not whitespace, or end.
+inline const char *scan_skip_spaces(const char *p, const char *end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    while (end - p >= simd_scan::WIDTH) {
+        if (const uint32_t stop = ~simd_scan::space_mask(simd_scan::load(p)) & simd_scan::ALL) {
+            return p + __builtin_ctz(stop);
+        }
+        p += simd_scan::WIDTH;
+    }
+#endif
+    while (p < end && simd_scan::is_space(*p)) ++p;
+    return p;
+}
+
+// First whitespace or NUL at or after p, or end.
+inline const char *scan_find_space(const char *p, const char *end) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    while (end - p >= simd_scan::WIDTH) {
+        const simd_scan::Block v = simd_scan::load(p);
+        if (const uint32_t stop = simd_scan::space_mask(v) | simd_scan::equal_mask(v, '\0')) {
+            return p + __builtin_ctz(stop);
+        }
+        p += simd_scan::WIDTH;
+    }
+#endif
+    while (p < end && *p && !simd_scan::is_space(*p)) ++p;
+    return p;
+}
+
+// First c or NUL at or after p, or end.
+inline const char *scan_find_char(const char *p, const char *end, const char c) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    while (end - p >= simd_scan::WIDTH) {
+        const simd_scan::Block v = simd_scan::load(p);
+        if (const uint32_t stop = simd_scan::equal_mask(v, c) | simd_scan::equal_mask(v, '\0')) {
+            return p + __builtin_ctz(stop);
+        }
+        p += simd_scan::WIDTH;
+    }
+#endif
+    while (p < end && *p && *p != c) ++p;
+    return p;
+}
+
+#endif //SIMDSCAN_H
@@ -0,0 +1,83 @@
+#ifndef SOURCEFILE_H
+#define SOURCEFILE_H
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A source file mapped read only, the tokenizer reads it in place.
+// Pipes, /dev/stdin and procfs files report no size and cannot be mapped,
+// they are read into a buffer instead.
+// The text is not NUL terminated, token streams stop at its end.
+class SourceFile {
+public:
+    explicit SourceFile(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open " + path + ": " + std::strerror(errno));
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Could not stat " + path + ": " + std::strerror(error));
+        }
+        // procfs files are regular but report size 0
+        if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+            readAll(fd, path);
+            ::close(fd);
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Could not map " + path + ": " + std::strerror(error));
+        }
+        // read once front to back
+        madvise(mapped, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(mapped);
+        ::close(fd);
+    }
+
+    ~SourceFile() {
+        if (data_) munmap(const_cast<char *>(data_), size_);
+    }
+
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    [[nodiscard]] std::string_view text() const {
+        if (data_ == nullptr) return buffer_;
+        return {data_, size_};
+    }
+
+private:
+    void readAll(const int fd, const std::string &path) {
+        char block[1 << 16];
+        while (true) {
+            const ssize_t n = ::read(fd, block, sizeof(block));
+            if (n == 0) break;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                const int error = errno;
+                ::close(fd);
+                throw std::runtime_error("Could not read " + path + ": " + std::strerror(error));
+            }
+            buffer_.append(block, static_cast<size_t>(n));
+        }
+    }
+
+    const char *data_ = nullptr; // mapped regular file
+    size_t size_ = 0;
+    std::string buffer_; // anything else, read whole
+};
+
+#endif //SOURCEFILE_H
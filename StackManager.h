@@ -6,6 +6,9 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
 
 
 // Forward declaration
@@ -81,7 +84,7 @@ public:
             :
             : "r"(dsPtr) // input
         );
-        std::fill(dsStack, dsStack + dsSize, 0);
+        clearStack(dsStack, dsSize, dsTop, dsPeak);
     }
 
     uint64_t popDS()
@@ -171,7 +174,7 @@ public:
             :
             : "r"(rsPtr) // input
         );
-        std::fill(rsStack, rsStack + rsSize, 0);
+        clearStack(rsStack, rsSize, rsTop, rsPeak);
     }
 
     uint64_t popRS()
@@ -231,7 +234,7 @@ public:
             :
             : "r"(lsPtr) // input
         );
-        std::fill(lsStack, lsStack + lsSize, 0);
+        clearStack(lsStack, lsSize, lsTop, lsPeak);
     }
 
     uint64_t popLS()
@@ -291,7 +294,7 @@ public:
             :
             : "r"(ssPtr) // input
         );
-        std::fill(ssStack, ssStack + ssSize, 0);
+        clearStack(ssStack, ssSize, ssTop, ssPeak);
     }
 
     uint64_t popSS()
@@ -487,6 +490,39 @@ public:
         return ssDepth / 8;
     }
 
+    // Deepest depth in cells each stack has reached since startup.
+    struct StackDepths
+    {
+        uint64_t ds, rs, ls, ss;
+    };
+
+    [[nodiscard]] StackDepths highWater() const
+    {
+        return {
+            std::max(dsPeak, depthFrom(dsTop, deepestWritten(dsStack, dsSize))),
+            std::max(rsPeak, depthFrom(rsTop, deepestWritten(rsStack, rsSize))),
+            std::max(lsPeak, depthFrom(lsTop, deepestWritten(lsStack, lsSize))),
+            std::max(ssPeak, depthFrom(ssTop, deepestWritten(ssStack, ssSize)))
+        };
+    }
+
+    // Allocated cells per stack
+    [[nodiscard]] StackDepths capacity() const
+    {
+        return {dsSize, rsSize, lsSize, ssSize};
+    }
+
+    // Cells per stack backed by resident pages, what the stacks really cost
+    [[nodiscard]] StackDepths residentCells() const
+    {
+        return {
+            residentBytes(dsStack, dsSize * sizeof(uint64_t)) / sizeof(uint64_t),
+            residentBytes(rsStack, rsSize * sizeof(uint64_t)) / sizeof(uint64_t),
+            residentBytes(lsStack, lsSize * sizeof(uint64_t)) / sizeof(uint64_t),
+            residentBytes(ssStack, ssSize * sizeof(uint64_t)) / sizeof(uint64_t)
+        };
+    }
+
     void displayStacks() const
     {
         uint64_t* currentDsPtr;
@@ -534,8 +570,11 @@ public:
             "\tSS (1)\tSS (2)\tSS (3)\tSS (4)\tSS (5)\tSS (6)\tSS (7)\tSS (8)\n";
         std::cout << "\t" << "\t" << "\t[" << ssValues[0] << "]\t[" << ssValues[1] << "]\t[" << ssValues[2] << "]\t[" <<
             ssValues[3] << "]\t"
-            << "[" << ssValues[4] << "]\t[" << ssValues[5] << "]\t[" << ssValues[6] << "]\t[" << ssValues[7] << "]\n"
-            << std::endl;
+            << "[" << ssValues[4] << "]\t[" << ssValues[5] << "]\t[" << ssValues[6] << "]\t[" << ssValues[7] << "]\n";
+
+        const StackDepths peak = highWater();
+        std::cout << "\tmax depth DS " << peak.ds << "  RS " << peak.rs << "  LS " << peak.ls << "  SS " << peak.ss
+            << "\n" << std::endl;
     }
 
 private:
@@ -585,6 +624,43 @@ private:
         );
     }
 
+    // Stacks are zeroed when created and by every reset, so the deepest non-zero cell
+    // is the deepest push since the last reset. A 0 pushed at the very bottom is missed.
+    static const uint64_t* deepestWritten(const uint64_t* stack, const size_t size)
+    {
+        return std::find_if(stack, stack + size, [](const uint64_t cell) { return cell != 0; });
+    }
+
+    static size_t residentBytes(const void* start, const size_t bytes)
+    {
+        const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t first = reinterpret_cast<uintptr_t>(start) & ~(pageSize - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(start) + bytes;
+        const size_t pages = (end - first + pageSize - 1) / pageSize;
+#ifdef __APPLE__
+        std::vector<char> resident(pages);
+#else
+        std::vector<unsigned char> resident(pages);
+#endif
+        if (mincore(reinterpret_cast<void*>(first), pages * pageSize, resident.data()) != 0) return bytes;
+        const auto count = static_cast<size_t>(std::count_if(resident.begin(), resident.end(),
+                                                             [](const auto page) { return page & 1; }));
+        return std::min(bytes, count * pageSize);
+    }
+
+    static uint64_t depthFrom(const uint64_t* top, const uint64_t* cell)
+    {
+        return cell < top ? top - cell : 0;
+    }
+
+    // Zero only the cells that were written, remembering how deep they went.
+    static void clearStack(uint64_t* stack, const size_t size, const uint64_t* top, uint64_t& peak)
+    {
+        const auto deepest = const_cast<uint64_t*>(deepestWritten(stack, size));
+        peak = std::max(peak, depthFrom(top, deepest));
+        std::fill(deepest, stack + size, 0);
+    }
+
     ~StackManager()
     {
         delete[] dsStack;
@@ -603,6 +679,12 @@ private:
     const size_t lsSize;
     const size_t ssSize;
 
+    // deepest depth seen before the last reset of each stack
+    uint64_t dsPeak = 0;
+    uint64_t rsPeak = 0;
+    uint64_t lsPeak = 0;
+    uint64_t ssPeak = 0;
+
 public:
     uint64_t* dsTop;
     uint64_t* dsPtr;
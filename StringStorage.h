@@ -6,6 +6,14 @@
 #include <vector>
 #include <iostream>
 #include <mutex>
+#include <algorithm>
+#include <cstring>
+
+// Count and payload bytes of the strings a manager holds, for *MEM.
+struct StringUsage {
+    size_t strings;
+    size_t bytes;
+};
 
 /**
  * GlobalString
@@ -75,7 +83,9 @@ private:
  * GlobalStringManager
  *  - Holds a map of interned strings -> stable char* memory
  *  - The same text always returns the same pointer
- *  - Freed (if ever) at program shutdown
+ *  - Strings created while compiling are captured and owned by the generated code,
+ *    they are freed when the last word referring to them is forgotten.
+ *  - Strings created outside a capture (interpreter s") live until program shutdown
  */
 class GlobalStringManager {
 public:
@@ -91,26 +101,109 @@ public:
 
         // Check if we have it already
         auto it = interned_.find(text);
-        if (it != interned_.end()) {
-            return GlobalString(it->second);
+        if (it == interned_.end()) {
+            // Otherwise, allocate new storage
+            char* storage = new char[text.size() + 1];
+            std::memcpy(storage, text.data(), text.size());
+            storage[text.size()] = '\0';
+            it = interned_.emplace(text, Entry{storage, 0, false}).first;
+            byPointer_[storage] = text;
         }
 
-        // Otherwise, allocate new permanent storage
-        char* storage = new char[text.size() + 1];
-        std::memcpy(storage, text.data(), text.size());
-        storage[text.size()] = '\0';
+        if (capturing()) {
+            captured().push_back(it->second.storage);
+        } else {
+            it->second.permanent = true;
+        }
+        return GlobalString(it->second.storage);
+    }
+
+    // Start recording strings used by the code being compiled on this thread.
+    void beginCapture() {
+        captured().clear();
+        capturing() = true;
+    }
+
+    // Stop recording, each distinct string gains a reference owned by the caller.
+    std::vector<const char*> endCapture() {
+        std::vector<const char*> owned = std::move(captured());
+        captured().clear();
+        capturing() = false;
+        std::sort(owned.begin(), owned.end());
+        owned.erase(std::unique(owned.begin(), owned.end()), owned.end());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const char* p : owned) {
+            ++interned_.at(byPointer_.at(p)).refs;
+        }
+        return owned;
+    }
+
+    // Scoped capture, a definition that throws before finish() gives its strings back.
+    // Captures nest (EVALUATE compiling a string while another word is compiled),
+    // the outer capture carries on with its strings when the inner one ends.
+    class Capture {
+    public:
+        Capture() : outer_(std::move(captured())), outerCapturing_(capturing()) { instance().beginCapture(); }
+        ~Capture() {
+            if (active_) instance().release(instance().endCapture());
+            restoreOuter();
+        }
+        Capture(const Capture&) = delete;
+        Capture& operator=(const Capture&) = delete;
+
+        std::vector<const char*> finish() {
+            active_ = false;
+            std::vector<const char*> owned = instance().endCapture();
+            restoreOuter();
+            return owned;
+        }
 
-        interned_[text] = storage;
-        return GlobalString(storage);
+    private:
+        void restoreOuter() {
+            if (restored_) return;
+            captured() = std::move(outer_);
+            capturing() = outerCapturing_;
+            restored_ = true;
+        }
+
+        std::vector<const char*> outer_;
+        bool outerCapturing_;
+        bool active_ = true;
+        bool restored_ = false;
+    };
+
+    // Drop references taken by endCapture, unreferenced strings are freed.
+    void release(const std::vector<const char*>& owned) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const char* p : owned) {
+            const auto key = byPointer_.find(p);
+            if (key == byPointer_.end()) continue;
+            const auto it = interned_.find(key->second);
+            if (--it->second.refs == 0 && !it->second.permanent) {
+                delete[] it->second.storage;
+                interned_.erase(it);
+                byPointer_.erase(key);
+            }
+        }
     }
 
+    StringUsage usage() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        StringUsage total{interned_.size(), 0};
+        for (const auto& entry : interned_) {
+            total.bytes += entry.first.size() + 1;
+        }
+        return total;
+    }
 
     // List all interned strings.
     void listStrings() const {
 
         for (const auto& entry : interned_) {
             std::cout << "Key: " << entry.first
-                      << ", Value: " << entry.second << "\n";
+                      << ", Value: " << entry.second.storage
+                      << ", Refs: " << entry.second.refs << "\n";
         }
     }
 
@@ -121,7 +214,24 @@ private:
     GlobalStringManager(const GlobalStringManager&) = delete;
     GlobalStringManager& operator=(const GlobalStringManager&) = delete;
 
-    std::unordered_map<std::string, const char*> interned_;
+    struct Entry {
+        char* storage;
+        size_t refs;     // words whose code embeds the address
+        bool permanent;  // handed out by the interpreter, never freed
+    };
+
+    static bool& capturing() {
+        static thread_local bool active = false;
+        return active;
+    }
+
+    static std::vector<const char*>& captured() {
+        static thread_local std::vector<const char*> strings;
+        return strings;
+    }
+
+    std::unordered_map<std::string, Entry> interned_;
+    std::unordered_map<const char*, std::string> byPointer_;
     std::mutex mutex_;
 };
 
@@ -136,7 +246,8 @@ private:
 class TransientStringManager {
 public:
     static TransientStringManager& instance() {
-        static TransientStringManager theInstance;
+        // one per compiling thread
+        static thread_local TransientStringManager theInstance;
         return theInstance;
     }
 
@@ -167,6 +278,15 @@ public:
         return TransientString(storage);
     }
 
+    // Of the calling thread, the manager is per thread
+    StringUsage usage() const {
+        StringUsage total{allocated_.size(), 0};
+        for (const auto ptr : allocated_) {
+            total.bytes += std::strlen(ptr) + 1;
+        }
+        return total;
+    }
+
     // Optional: list or print the currently allocated transient strings (for debugging)
     void listTransientStrings() const {
         std::cout << "Currently allocated transient strings:\n";
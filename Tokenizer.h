@@ -0,0 +1,247 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "utility.h"
+#include "SimdScan.h"
+
+typedef enum {
+    TOKEN_WORD,
+    TOKEN_NUMBER,
+    TOKEN_FLOAT,
+    TOKEN_STRING,
+    TOKEN_UNKNOWN,
+    TOKEN_COMPILING,
+    TOKEN_INTERPRETING,
+    TOKEN_END
+} TokenType;
+
+// A token views its text in the source that was tokenized, nothing is copied.
+// The view is valid while that source is, which is for the interpreter call.
+struct Token {
+    TokenType type = TOKEN_END;
+    uint32_t length = 0;
+    const char *text = ""; // not NUL terminated
+
+    union {
+        int64_t int_value = 0;
+        double float_value;
+    };
+
+    [[nodiscard]] std::string_view view() const {
+        return {text, length};
+    }
+
+    [[nodiscard]] std::string str() const {
+        return std::string(text, length);
+    }
+};
+
+
+// The source runs to end, a NUL before it also ends the text.
+inline void skip_whitespace(const char **input, const char *end) {
+    *input = scan_skip_spaces(*input, end);
+}
+
+
+// BASE, the radix of integer literals written without a 0x or 0b prefix.
+// A cell so Forth code can @ and ! it, values outside 2..36 read as decimal.
+inline int64_t numberBase = 10;
+
+inline int digit_value(const char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return 36;
+}
+
+// Numbers and floats start with a digit, a sign or a dot, anything else is a word
+// and needs no scan to classify.
+inline bool could_be_number(const char *text) {
+    return isdigit(static_cast<unsigned char>(*text)) || *text == '-' || *text == '+' || *text == '.';
+}
+
+// Classify and convert a numeric token in one pass over its text.
+//   integers  [-]digits in BASE, [-]0x hex, [-]0b binary, up to 64 bits. A prefix
+//             letter that is a digit in BASE is a digit: in hex 0b1 is 0xb1.
+//   floats    [+-]digits with a '.', or in decimal an exponent: 1.5 .5 2. 1e3 -2.5e-3
+// In bases above ten a literal still starts with a decimal digit, so no word is
+// read as a number. Returns false when the text is a word, a literal that does not
+// fit 64 bits throws. Hex and binary take any 64 bit pattern, BASE literals have
+// to fit a signed cell.
+inline bool scan_number(const std::string_view text, Token &token) {
+    size_t i = 0;
+    const bool negative = text[0] == '-';
+    if (text[0] == '-' || text[0] == '+') i = 1;
+
+    int base = numberBase >= 2 && numberBase <= 36 ? static_cast<int>(numberBase) : 10;
+    bool prefixed = false;
+    if (text[0] != '+' && i + 2 < text.size() && text[i] == '0') {
+        const char radix = static_cast<char>(text[i + 1] | 0x20);
+        if ((radix == 'x' || radix == 'b') && digit_value(radix) >= base) {
+            base = radix == 'x' ? 16 : 2;
+            prefixed = true;
+            i += 2;
+        }
+    }
+
+    // integer digits, stopping at the first character that is not one
+    const size_t digitsStart = i;
+    uint64_t magnitude = 0;
+    bool overflow = false;
+    for (; i < text.size(); i++) {
+        const int digit = digit_value(text[i]);
+        if (digit >= base) break;
+        overflow |= __builtin_mul_overflow(magnitude, static_cast<uint64_t>(base), &magnitude);
+        overflow |= __builtin_add_overflow(magnitude, static_cast<uint64_t>(digit), &magnitude);
+    }
+    const bool leadingDigit = i > digitsStart &&
+                              (prefixed || isdigit(static_cast<unsigned char>(text[digitsStart])));
+
+    if (i == text.size() && leadingDigit && text[0] != '+') {
+        const uint64_t limit = prefixed ? UINT64_MAX : negative ? uint64_t{1} << 63 : INT64_MAX;
+        if (overflow || magnitude > limit) {
+            throw std::runtime_error("Number out of range: " + std::string(text));
+        }
+        token.type = TOKEN_NUMBER;
+        token.int_value = static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+        return true;
+    }
+
+    // not an integer, a float is decimal digits with a fraction or an exponent
+    if (prefixed) return false;
+    i = text[0] == '-' || text[0] == '+' ? 1 : 0;
+    bool mantissaDigits = false;
+    bool fraction = false;
+    bool exponent = false;
+    while (i < text.size() && isdigit(static_cast<unsigned char>(text[i]))) {
+        mantissaDigits = true;
+        i++;
+    }
+    if (i < text.size() && text[i] == '.') {
+        fraction = true;
+        i++;
+        while (i < text.size() && isdigit(static_cast<unsigned char>(text[i]))) {
+            mantissaDigits = true;
+            i++;
+        }
+    }
+    if (mantissaDigits && i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) i++;
+        const size_t exponentStart = i;
+        while (i < text.size() && isdigit(static_cast<unsigned char>(text[i]))) i++;
+        exponent = i > exponentStart;
+        if (!exponent) return false;
+    }
+    if (i != text.size() || !mantissaDigits || !(fraction || exponent)) {
+        return false;
+    }
+
+    // from_chars takes no leading '+'
+    const char *first = text.data() + (text[0] == '+' ? 1 : 0);
+    double value = 0;
+    const auto result = std::from_chars(first, text.data() + text.size(), value);
+    if (result.ec == std::errc::result_out_of_range) {
+        throw std::runtime_error("Number out of range: " + std::string(text));
+    }
+    token.type = TOKEN_FLOAT;
+    token.float_value = value;
+    return true;
+}
+
+// A whole word that may be a literal, as the compiler and the meta commands see it.
+inline bool scan_literal(const std::string_view text, Token &token) {
+    return !text.empty() && could_be_number(text.data()) && scan_number(text, token);
+}
+
+// With numbers false, numeric tokens are returned as words.
+inline Token get_next_token(const char **input, const char *end, const bool numbers = true) {
+    Token token;
+    skip_whitespace(input, end);
+
+    if (*input == end || **input == '\0') {
+        token.type = TOKEN_END;
+        return token;
+    }
+
+    const char *start = *input;
+    *input = scan_find_space(start, end);
+    token.text = start;
+    token.length = static_cast<uint32_t>(*input - start);
+    const std::string_view text = token.view();
+
+    // Check for compilation/interpreting tokens
+    if (text == ":" || text == "]") {
+        token.type = TOKEN_COMPILING;
+    } else if (text == ";" || text == "[") {
+        token.type = TOKEN_INTERPRETING;
+    }
+    // Handle words ending in quotes
+    else if (text.back() == '"') {
+        token.type = TOKEN_WORD;
+        (*input)--; // Backtrack so the " starts a new string literal
+    } else if (numbers && could_be_number(start) && scan_number(text, token)) {
+        // type and value set by the scanner
+    }
+    // Handle regular words
+    else {
+        token.type = TOKEN_WORD;
+    }
+    return token;
+}
+
+
+inline Token get_string_token(const char **input, const char *end) {
+    Token token;
+    token.type = TOKEN_STRING;
+    (*input)++; // Consume opening "
+    if (*input < end && **input == ' ') {
+        (*input)++; // Consume that one space
+    }
+    const char *start = *input;
+    *input = scan_find_char(start, end, '"');
+    token.text = start;
+    token.length = static_cast<uint32_t>(*input - start);
+    if (*input < end && **input == '"') {
+        (*input)++; // Consume closing quote
+    }
+    return token;
+}
+
+
+inline void print_token(const Token *token) {
+    switch (token->type) {
+        case TOKEN_WORD:
+            printf("WORD: %.*s\n", static_cast<int>(token->length), token->text);
+            break;
+        case TOKEN_NUMBER:
+            printf("NUMBER: %lld\n", static_cast<long long>(token->int_value));
+            break;
+        case TOKEN_FLOAT:
+            printf("FLOAT: %f\n", token->float_value);
+            break;
+        case TOKEN_STRING:
+            printf("STRING: \"%.*s\"\n", static_cast<int>(token->length), token->text);
+            break;
+        case TOKEN_COMPILING:
+            printf("COMPILING\n");
+            break;
+        case TOKEN_INTERPRETING:
+            printf("INTERPRETING\n");
+            break;
+
+        default:
+            printf("UNKNOWN\n");
+            break;
+    }
+}
+
+#endif //TOKENIZER_H
@@ -0,0 +1,82 @@
+#ifndef WORDSTATS_H
+#define WORDSTATS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Counters updated by the generated code of one word, see JitGenerator::genStatsEntry.
+// The layout is used by the generated code, calls must stay at offset 0 and cycles at 8.
+struct WordStats {
+    uint64_t calls;  // entries, including recursive ones
+    uint64_t cycles; // inclusive time stamp counter ticks
+    char name[32];
+
+    void setName(const std::string &wordName) {
+        std::strncpy(name, wordName.c_str(), sizeof(name));
+        name[sizeof(name) - 1] = '\0';
+    }
+};
+
+/**
+ * WordStatsTable
+ *  - Owns the stats records of words compiled with *STATS ON.
+ *  - Records never move (deque), generated code holds their address.
+ *  - Records outlive FORGET, so counts of a forgotten word are still reported.
+ */
+class WordStatsTable {
+public:
+    static WordStatsTable &getInstance() {
+        static WordStatsTable instance;
+        return instance;
+    }
+
+    WordStatsTable(const WordStatsTable &) = delete;
+    WordStatsTable &operator=(const WordStatsTable &) = delete;
+
+    WordStats *allocate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return &records_.emplace_back(WordStats{0, 0, {}});
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &record: records_) {
+            record.calls = record.cycles = 0;
+        }
+    }
+
+    // .STATS, words sorted by total cycles
+    void display() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<const WordStats *> called;
+        for (const auto &record: records_) {
+            if (record.calls > 0) called.push_back(&record);
+        }
+        std::ranges::sort(called, [](const auto *a, const auto *b) { return a->cycles > b->cycles; });
+
+        std::cout << std::left << std::setw(32) << "word" << std::right
+                << std::setw(14) << "calls" << std::setw(18) << "cycles" << std::setw(14) << "cycles/call"
+                << std::endl;
+        for (const auto *record: called) {
+            std::cout << std::left << std::setw(32) << record->name << std::right
+                    << std::setw(14) << record->calls
+                    << std::setw(18) << record->cycles
+                    << std::setw(14) << record->cycles / record->calls << std::endl;
+        }
+    }
+
+private:
+    WordStatsTable() = default;
+
+    std::deque<WordStats> records_;
+    std::mutex mutex_;
+};
+
+#endif //WORDSTATS_H
@@ -0,0 +1,522 @@
+// jitforth_bench
+// Runs classic Forth workloads headless and prints the timings as JSON.
+//
+//   jitforth_bench [--iterations-scale N] [--filter name]
+//   jitforth_bench --prims [--filter name]
+//   jitforth_bench --compile [--iterations-scale N]
+//
+// Each workload defines its words once, then compiles its operation into a word
+// that is run for a warmup and a timed number of iterations. Only the JIT code is
+// timed, the interpreter is not on the measured path.
+//
+// --prims measures every primitive with a generator on its own: a word repeats the
+// primitive in an unrolled loop, balanced so the data stack depth stays constant.
+//
+// --compile measures the compiler instead: thousands of generated definitions of
+// varying size and nesting go through interpretText, reported as words per second,
+// per-definition latency percentiles and time split by compiler phase.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "interpreter.h"
+#include "Words.h"
+#include "BenchSupport.h"
+
+#ifndef FACT_F_PATH
+#define FACT_F_PATH "fact.f"
+#endif
+
+struct Workload {
+    std::string name;
+    std::string setup;                 // definitions, interpreted once
+    std::string setupFile;             // or a source file loaded once
+    std::string op;                    // body of the timed word
+    std::optional<uint64_t> expected;  // top of stack after one op
+    uint64_t iterations;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0;
+    uint64_t result = 0;
+    bool ok = false;
+    std::string error;
+};
+
+static uint64_t expectedMatmulSum() {
+    uint64_t sum = 0;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            for (int n = 0; n < 8; ++n) {
+                sum += static_cast<uint64_t>(((row * 8 + n) & 7) + 1) * (((n * 8 + col) & 3) + 1);
+            }
+        }
+    }
+    return sum;
+}
+
+static std::vector<Workload> workloads() {
+    return {
+        {
+            "sieve",
+            "8190 array flags "
+            ": sieve 0 8190 0 do 1 i to flags loop "
+            "8190 0 do i flags if i 2* 3 + dup i + "
+            "begin dup 8190 < while 0 over to flags over + repeat drop drop 1+ then loop ;", "",
+            "sieve", 1899, 200
+        },
+        {
+            "fib",
+            ": fib dup 2 < if exit then dup 1- recurse swap 2 - recurse + ;", "",
+            "25 fib", 75025, 20
+        },
+        {
+            "fact",
+            "", FACT_F_PATH,
+            "20 FACTORIAL drop 20 fact drop 20 rfact", 2432902008176640000ULL, 100000
+        },
+        {
+            "bubble_sort",
+            "100 array bdata "
+            ": bfill 100 0 do 100 i - i to bdata loop ; "
+            ": bsort 100 1 do 100 i - 0 do i bdata i 1+ bdata > if "
+            "i bdata i 1+ bdata i to bdata i 1+ to bdata then loop loop ;", "",
+            "bfill bsort 0 bdata", 1, 200
+        },
+        {
+            "matmul",
+            "64 array ma 64 array mb 64 array mc "
+            ": minit 64 0 do i 7 and 1+ i to ma i 3 and 1+ i to mb loop ; "
+            ": mmul 8 0 do 8 0 do 0 8 0 do k 8 * i + ma i 8 * j + mb * + loop j 8 * i + to mc loop loop ; "
+            ": msum 0 64 0 do i mc + loop ; minit", "",
+            "mmul msum", expectedMatmulSum(), 2000
+        },
+        {
+            "case_dispatch",
+            ": dispatch case 1 of 10 endof 2 of 20 endof 3 of 30 endof default 0 endcase ;", "",
+            "0 100 0 do i 4 mod dispatch + loop", 1500, 10000
+        },
+        {
+            "print_strings",
+            ": hello .\" Hello, World \" ;", "",
+            "100 0 do hello loop 0", 0, 1000
+        },
+    };
+}
+
+static Result run(const Workload &workload, const uint64_t scale) {
+    Result result;
+    result.name = workload.name;
+    result.iterations = std::max<uint64_t>(1, workload.iterations * scale);
+
+    try {
+        if (!workload.setupFile.empty()) {
+            interpretText(readFile(workload.setupFile));
+        }
+        interpreter(workload.setup);
+        const std::string opWord = "bench-" + workload.name;
+        interpreter(": " + opWord + " " + workload.op + " ;");
+        const ForthWord *word = d.findWord(opWord.c_str());
+        if (word == nullptr || word->compiledFunc == nullptr) {
+            throw std::runtime_error("benchmark word did not compile");
+        }
+
+        sm.resetDS();
+        exec(word->compiledFunc);
+        result.result = sm.popDS();
+        result.ok = !workload.expected || result.result == *workload.expected;
+
+        const uint64_t warmup = std::max<uint64_t>(1, result.iterations / 10);
+        sm.resetDS();
+        for (uint64_t i = 0; i < warmup; ++i) {
+            exec(word->compiledFunc);
+            sm.popDS();
+        }
+
+        // every op leaves one result, popping it is much cheaper than resetDS
+        sm.resetDS();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < result.iterations; ++i) {
+            exec(word->compiledFunc);
+            sm.popDS();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        result.nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / result.iterations;
+    } catch (const std::exception &e) {
+        result.ok = false;
+        result.error = e.what();
+    }
+    sm.resetDS();
+    return result;
+}
+
+struct PrimitiveResult {
+    std::string name;
+    int stackEffect = 0;
+    std::string balance;
+    double nsPerOp = 0;
+    double bytesPerOp = 0;
+    std::string error;
+};
+
+// Primitives that touch memory, the return stack, control flow or output are not
+// safe (or not meaningful) to repeat with arbitrary stack contents.
+static const std::unordered_set<std::string> primitiveDenylist = {
+    "forget", "emit", ".", "h.", "f.", "s.", "@", "!", "sp!", "rp!", ">r", "r>", "r@", "rp@",
+    "sp", "sp@", "i", "j", "k",
+};
+
+constexpr int PRIM_SEEDS = 8;      // values on the stack while a primitive runs
+constexpr int PRIM_UNROLL = 64;    // instances per loop iteration
+constexpr int PRIM_LOOPS = 100;    // loop iterations per run
+constexpr int PRIM_RUNS = 200;     // timed runs
+
+static bool isNumberName(const std::string &name) {
+    char *end = nullptr;
+    std::strtoll(name.c_str(), &end, 0);
+    return end != name.c_str() && *end == '\0';
+}
+
+struct Seed {
+    std::string source; // pushes one value
+    uint64_t value;
+};
+
+// float primitives get 2.0, the integer 2 would be a denormal and time microcode assists
+static Seed primitiveSeed(const std::string &name) {
+    if (name.front() != 'f') return {"2", 2};
+    const double seed = 2.0;
+    uint64_t bits;
+    std::memcpy(&bits, &seed, sizeof(bits));
+    return {"2 float", bits};
+}
+
+// run the primitive's own compiled word and see how far the depth moves
+static int measureStackEffect(const ForthWord *word, const Seed &seed) {
+    sm.resetDS();
+    for (int i = 0; i < PRIM_SEEDS; ++i) {
+        sm.pushDS(seed.value);
+    }
+    const auto before = static_cast<int>(sm.getDSDepth());
+    exec(word->compiledFunc);
+    const auto after = static_cast<int>(sm.getDSDepth());
+    sm.resetDS();
+    return after - before;
+}
+
+static const ForthWord *compileBenchWord(const std::string &name, const std::string &body) {
+    if (const ForthWord *old = d.findWord(name.c_str())) {
+        d.forgetThrough(old);
+        jc.releasePendingCode();
+    }
+    interpreter(": " + name + " " + body + " ;");
+    const ForthWord *word = d.findWord(name.c_str());
+    if (word == nullptr || word->compiledFunc == nullptr) {
+        throw std::runtime_error("benchmark word did not compile");
+    }
+    return word;
+}
+
+static PrimitiveResult runPrimitive(const ForthWord *primitive) {
+    PrimitiveResult result;
+    result.name = primitive->name;
+    try {
+        const Seed seed = primitiveSeed(result.name);
+        result.stackEffect = measureStackEffect(primitive, seed);
+        if (result.stackEffect > PRIM_SEEDS || result.stackEffect < -PRIM_SEEDS) {
+            throw std::runtime_error("stack effect too large");
+        }
+
+        // one instance plus whatever keeps the depth unchanged
+        std::string instance;
+        for (int i = 0; i < -result.stackEffect; ++i) instance += seed.source + " ";
+        instance += result.name;
+        for (int i = 0; i < result.stackEffect; ++i) instance += " drop";
+        result.balance = instance;
+
+        std::string seeds;
+        for (int i = 0; i < PRIM_SEEDS; ++i) seeds += seed.source + " ";
+        std::string unrolled;
+        for (int i = 0; i < PRIM_UNROLL; ++i) unrolled += " " + instance;
+
+        const std::string loop = std::to_string(PRIM_LOOPS) + " 0 do";
+        const ForthWord *empty = compileBenchWord("bench-prim-empty", seeds + loop + " loop");
+        const size_t emptyBytes = jc.codeSizeOf(reinterpret_cast<void *>(empty->compiledFunc));
+        const ForthWord *word = compileBenchWord("bench-prim", seeds + loop + unrolled + " loop");
+        const size_t bytes = jc.codeSizeOf(reinterpret_cast<void *>(word->compiledFunc));
+        result.bytesPerOp = static_cast<double>(bytes - emptyBytes) / PRIM_UNROLL;
+
+        // the word leaves the seeds behind, one reset per run keeps the stack bounded
+        sm.resetDS();
+        exec(word->compiledFunc);
+        sm.resetDS();
+        std::chrono::steady_clock::duration elapsed{};
+        for (int run = 0; run < PRIM_RUNS; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            exec(word->compiledFunc);
+            elapsed += std::chrono::steady_clock::now() - start;
+            for (int i = 0; i < PRIM_SEEDS; ++i) sm.popDS();
+        }
+        result.nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() /
+                         (static_cast<double>(PRIM_RUNS) * PRIM_LOOPS * PRIM_UNROLL);
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+    sm.resetDS();
+    return result;
+}
+
+static std::vector<PrimitiveResult> runPrimitives(const std::string &filter) {
+    std::vector<const ForthWord *> primitives;
+    std::unordered_set<std::string> seen;
+    for (const ForthWord *word = d.getLatestWord(); word != nullptr; word = word->link) {
+        const std::string name = word->name;
+        if (word->generatorFunc == nullptr || word->compiledFunc == nullptr) continue;
+        if (primitiveDenylist.contains(name) || isNumberName(name)) continue;
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+        if (!seen.insert(name).second) continue; // later definitions shadow earlier ones
+        primitives.push_back(word);
+    }
+    std::ranges::reverse(primitives); // registration order
+
+    std::vector<PrimitiveResult> results;
+    for (const ForthWord *primitive: primitives) {
+        results.push_back(runPrimitive(primitive));
+    }
+    return results;
+}
+
+static std::string jsonEscape(const std::string &text) {
+    std::string escaped;
+    for (const char c: text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static void printJson(const std::vector<Result> &results) {
+    std::cout << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        std::cout << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << std::fixed << std::setprecision(1) << r.nsPerOp
+                << ", \"result\": " << r.result
+                << ", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.error.empty()) {
+            std::cout << ", \"error\": \"" << jsonEscape(r.error) << "\"";
+        }
+        std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}" << std::endl;
+}
+
+static void printPrimitivesJson(const std::vector<PrimitiveResult> &results) {
+    std::cout << "{\n  \"primitives\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const PrimitiveResult &r = results[i];
+        std::cout << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"stack_effect\": " << r.stackEffect
+                << ", \"balanced_as\": \"" << jsonEscape(r.balance) << "\""
+                << ", \"ns_per_op\": " << std::fixed << std::setprecision(2) << r.nsPerOp
+                << ", \"bytes_per_op\": " << std::setprecision(1) << r.bytesPerOp;
+        if (!r.error.empty()) {
+            std::cout << ", \"error\": \"" << jsonEscape(r.error) << "\"";
+        }
+        std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}" << std::endl;
+}
+
+// Deterministic colon definitions: straight-line code, control structures nested up to
+// three deep and calls to earlier generated words, between 5 and about 200 tokens each.
+class DefinitionGenerator {
+public:
+    explicit DefinitionGenerator(const uint32_t seed) : random_(seed) {
+    }
+
+    std::string next(const size_t index) {
+        const size_t budget = 5 + pick(196);
+        std::string body;
+        size_t tokens = 0;
+        while (tokens < budget) {
+            tokens += emit(body, 0, index);
+        }
+        return ": syn" + std::to_string(index) + body + " ;";
+    }
+
+private:
+    size_t pick(const size_t n) {
+        return std::uniform_int_distribution<size_t>(0, n - 1)(random_);
+    }
+
+    size_t emit(std::string &out, const int depth, const size_t index) {
+        static const char *simple[] = {"dup", "drop", "swap", "over", "+", "-", "*", "1+", "and", "or", "rot"};
+        const size_t choice = pick(depth < 3 ? 10 : 7);
+        if (choice < 4) {
+            out += " " + std::string(simple[pick(std::size(simple))]);
+            return 1;
+        }
+        if (choice < 6) {
+            out += " " + std::to_string(pick(1000));
+            return 1;
+        }
+        if (choice < 7) {
+            if (index == 0) return 0;
+            out += " syn" + std::to_string(pick(index));
+            return 1;
+        }
+
+        size_t tokens = 0;
+        const size_t inner = 1 + pick(4);
+        switch (choice) {
+            case 7:
+                out += " if";
+                for (size_t i = 0; i < inner; ++i) tokens += emit(out, depth + 1, index);
+                out += " else";
+                for (size_t i = 0; i < inner; ++i) tokens += emit(out, depth + 1, index);
+                out += " then";
+                return tokens + 3;
+            case 8:
+                out += " begin";
+                for (size_t i = 0; i < inner; ++i) tokens += emit(out, depth + 1, index);
+                out += " dup until";
+                return tokens + 3;
+            default:
+                out += " 10 0 do i";
+                for (size_t i = 0; i < inner; ++i) tokens += emit(out, depth + 1, index);
+                out += " drop loop";
+                return tokens + 6;
+        }
+    }
+
+    std::mt19937 random_;
+};
+
+struct CompileResult {
+    size_t words;
+    double seconds;
+    double p50Us;
+    double p99Us;
+    CompileTimings timings;
+};
+
+static CompileResult runCompile(const size_t definitions) {
+    DefinitionGenerator generator(42);
+    std::string source;
+    for (size_t i = 0; i < definitions; ++i) {
+        source += generator.next(i) + "\n";
+    }
+
+    jc.parallelCompileOFF();
+    jc.compileTimings.reset();
+    jc.compileTimings.enabled = true;
+    const auto start = std::chrono::steady_clock::now();
+    interpretText(source);
+    const auto end = std::chrono::steady_clock::now();
+    jc.compileTimings.enabled = false;
+
+    CompileResult result{};
+    result.timings = jc.compileTimings;
+    result.words = result.timings.definitionNs.size();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    std::vector<uint64_t> sorted = result.timings.definitionNs;
+    std::ranges::sort(sorted);
+    if (!sorted.empty()) {
+        result.p50Us = sorted[sorted.size() / 2] / 1e3;
+        result.p99Us = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)] / 1e3;
+    }
+    return result;
+}
+
+static void printCompileJson(const CompileResult &r, const size_t expected) {
+    const CompileTimings &t = r.timings;
+    const uint64_t codegenNs = t.compileNs - std::min(t.compileNs, t.lookupNs + t.rtAddNs);
+    std::cout << std::fixed << std::setprecision(3)
+            << "{\n  \"compile\": {\"words\": " << r.words << ", \"expected\": " << expected
+            << ", \"seconds\": " << r.seconds
+            << ", \"words_per_sec\": " << (r.seconds > 0 ? r.words / r.seconds : 0.0)
+            << ", \"p50_us\": " << r.p50Us << ", \"p99_us\": " << r.p99Us
+            << ",\n    \"breakdown_ms\": {\"tokenize\": " << t.tokenizeNs / 1e6
+            << ", \"lookup\": " << t.lookupNs / 1e6
+            << ", \"codegen\": " << codegenNs / 1e6
+            << ", \"rt_add\": " << t.rtAddNs / 1e6 << "}}\n}" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t scale = 1;
+    std::string filter;
+    bool primitives = false;
+    bool compile = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations-scale" && i + 1 < argc) {
+            scale = std::stoull(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--prims") {
+            primitives = true;
+        } else if (arg == "--compile") {
+            compile = true;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--prims | --compile] [--iterations-scale N] [--filter name]"
+                    << std::endl;
+            return 2;
+        }
+    }
+
+    if (primitives) {
+        std::vector<PrimitiveResult> results;
+        {
+            QuietStdout quiet;
+            jc.loggingOFF();
+            add_words();
+            results = runPrimitives(filter);
+        }
+        printPrimitivesJson(results);
+        return 0;
+    }
+
+    if (compile) {
+        const size_t definitions = 2000 * scale;
+        CompileResult result;
+        {
+            QuietStdout quiet;
+            jc.loggingOFF();
+            add_words();
+            result = runCompile(definitions);
+        }
+        printCompileJson(result, definitions);
+        return result.words == definitions ? 0 : 1;
+    }
+
+    std::vector<Result> results;
+    {
+        QuietStdout quiet;
+        jc.loggingOFF();
+        add_words();
+        for (const auto &workload: workloads()) {
+            if (!filter.empty() && workload.name.find(filter) == std::string::npos) continue;
+            results.push_back(run(workload, scale));
+        }
+    }
+
+    printJson(results);
+    for (const auto &r: results) {
+        if (!r.ok) return 1;
+    }
+    return 0;
+}
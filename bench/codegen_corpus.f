@@ -0,0 +1,35 @@
+: cg-add 100 + ;
+: cg-arith 10 3 mod 5 negate abs 4 9 min 15 5 max + + + ;
+: cg-within 5 1 10 within ;
+: cg-do-loop 0 11 1 do i + loop ;
+: cg-plus-loop do i 2 +loop ;
+: cg-nested-loops 3 0 do 2 0 do 1 0 do i j k + + loop loop loop ;
+: cg-begin-again 0 begin dup 10 < while 1+ again ;
+: cg-begin-repeat begin dup 10 < while 1+ repeat ;
+: cg-begin-until 0 begin 1+ dup 10 = until ;
+: cg-leave 0 begin 1+ dup 5 > if leave then dup 10 = until ;
+: cg-if-else if 1 else 2 then ;
+: cg-nested-if if if 1 else 2 then else 3 then ;
+: cg-locals { a b } a b + ;
+: cg-locals2 { a b | c } a b + to c c ;
+: cg-locals3 { a b | c -- d } a b + to c c 2* to d ;
+: cg-rstack 5 >r r@ r> + ;
+: cg-char char A ;
+: cg-fact dup 2 < if drop 1 exit then dup begin dup 2 > while 1- swap over * swap repeat drop ;
+: cg-rfact dup 2 < if drop 1 exit then dup 1- recurse * ;
+: cg-case
+  case
+    1 of 10 endof
+    2 of 20 endof
+    3 of 30 endof
+    default 40
+  endcase ;
+: cg-print ." codegen corpus" ;
+: cg-testcase
+  case
+    1 of ." One" endof
+    2 of ." Two" endof
+    3 of ." Three" endof
+    default ." Other"
+  endcase ;
+: cg-calls 5 cg-rfact cg-fact cg-add ;
@@ -0,0 +1,123 @@
+// jitforth_codegen_tests
+// Compiles a fixed corpus and checks the size of every generated word against a baseline.
+//
+//   jitforth_codegen_tests [--baseline path] [--tolerance percent] [--update]
+//
+// The corpus is every primitive built by add_words and the words in
+// bench/codegen_corpus.f, the definitions of fact.f, testcase.f and the basic
+// tests written for this tokenizer (no ( ... ) comments, one definition per name)
+// and kept fixed, so new tests or examples elsewhere do not change what is
+// measured. A corpus word that does not compile fails the run. For each word the byte size
+// and the instruction count are compared with the baseline; a word larger by more
+// than the tolerance (default 2%) in either fails the run. Words missing from the
+// baseline are listed as new and do not fail, a missing or empty baseline is
+// reported as a skipped test.
+// --update rewrites the baseline from this run after an intended change, the
+// result is checked in.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "interpreter.h"
+#include "Words.h"
+#include "BenchSupport.h"
+
+// exit status ctest reports as skipped, see SKIP_RETURN_CODE in CMakeLists.txt
+constexpr int SKIPPED = 77;
+
+#ifndef FORTH_SOURCE_DIR
+#define FORTH_SOURCE_DIR "."
+#endif
+
+// Each definition is compiled on its own, so a word that does not compile is
+// reported by name as a failure and the rest of the corpus is still measured.
+static std::vector<std::string> compileCorpus() {
+    std::vector<std::string> failures;
+    jc.codegenStatsON();
+    add_words();
+    add_interpreter_words();
+
+    const std::string source = readFile(FORTH_SOURCE_DIR "/bench/codegen_corpus.f");
+    TokenStream scan;
+    scan.openStructure(source);
+    for (size_t i = 0; scan[i].type != TOKEN_END; i++) {
+        scan.discardBefore(i);
+        const Token colon = scan[i];
+        if (colon.type != TOKEN_COMPILING || colon.view() != ":") continue;
+        const std::string name = scan[i + 1].str();
+
+        size_t end = i + 1;
+        Token token;
+        while ((token = scan[end]).type != TOKEN_END && !(token.type == TOKEN_INTERPRETING && token.view() == ";")) {
+            end++;
+        }
+        const char *last = token.type == TOKEN_END ? source.data() + source.size() : token.text + token.length;
+        try {
+            interpreter(std::string_view(colon.text, last - colon.text));
+        } catch (const std::exception &e) {
+            failures.push_back(name + ": " + e.what());
+        }
+        i = end;
+    }
+
+    jc.codegenStatsOFF();
+    jc.releasePendingCode();
+    return failures;
+}
+
+int main(int argc, char *argv[]) {
+    std::string baselinePath = FORTH_SOURCE_DIR "/bench/codegen_baseline.txt";
+    double tolerance = 2.0;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else if (arg == "--update") {
+            update = true;
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--baseline path] [--tolerance percent] [--update]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<std::string> failures;
+    {
+        QuietStdout quiet;
+        jc.loggingOFF();
+        failures = compileCorpus();
+    }
+    if (!failures.empty()) {
+        for (const auto &failure: failures) {
+            std::cout << "failed  " << failure << std::endl;
+        }
+        std::cout << failures.size() << " corpus words did not compile" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const CodegenStats &stats = CodegenStats::getInstance();
+    if (update) {
+        if (!stats.writeBaseline(baselinePath)) {
+            std::cerr << "could not write " << baselinePath << std::endl;
+            return 2;
+        }
+        std::cout << "wrote " << stats.entries().size() << " words to " << baselinePath << std::endl;
+        return 0;
+    }
+
+    const auto baseline = CodegenStats::loadBaseline(baselinePath);
+    if (baseline.empty()) {
+        // every word would be new, nothing is checked: reported to ctest as skipped
+        std::cerr << baselinePath << " has no entries, run " << argv[0]
+                << " --update and check the baseline in" << std::endl;
+        return SKIPPED;
+    }
+    const size_t regressions = stats.compare(baseline, tolerance, std::cout);
+    std::cout << stats.entries().size() << " words, " << regressions << " grew by more than "
+            << tolerance << "%" << std::endl;
+    return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -6,11 +6,21 @@
 #include <fstream>
 #include <regex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <tuple>
+#include <climits>
 #include "utility.h"
 #include "JitContext.h"
 #include "JitGenerator.h"
 #include "tests.h"
 #include "CompilerUtility.h"
+#include "CompilePool.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
+#include "MemoryReport.h"
+#include "SourceFile.h"
 #include <termios.h>
 #include <unistd.h>
 #include <cstdlib>
@@ -19,6 +29,7 @@
 #include <cstring>
 
 inline bool debug_enabled = false; // Debug flag (default: off)
+inline bool echo_enabled = true; // REPL feedback such as "Compiling word", off in batch mode
 
 // Function to enable or disable debug mode
 inline void set_debug_mode(bool enable) {
@@ -36,12 +47,15 @@ inline void enable_raw_mode(struct termios *orig_termios) {
     raw.c_cc[VMIN] = 1; // Min characters to read
     raw.c_cc[VTIME] = 0; // No timeout
     tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    // ask the terminal to mark pastes, see read_input_c
+    write(STDOUT_FILENO, "\033[?2004h", 8);
 
     if (debug_enabled) printf("DEBUG: Raw mode enabled\n");
 }
 
 // Restore original terminal settings
 void disable_raw_mode(struct termios *orig_termios) {
+    write(STDOUT_FILENO, "\033[?2004l", 8);
     tcsetattr(STDIN_FILENO, TCSAFLUSH, orig_termios);
     if (debug_enabled) printf("DEBUG: Raw mode disabled\n");
 }
@@ -52,24 +66,74 @@ void disable_raw_mode(struct termios *orig_termios) {
 std::vector<std::string> history; // Command history buffer
 int history_index = -1; // Index for navigating history
 
-inline void read_input_c(char *buffer, size_t max_length) {
+// Terminal input read in blocks, so a paste arrives in a few reads rather than
+// one read per byte. Screen updates are collected and written once, before the
+// next read would block and at the end of a line.
+struct TerminalInput {
+    char data[4096];
+    ssize_t size = 0;
+    ssize_t next = 0;
+    bool pasting = false; // between the bracketed paste start and end markers
+    std::string output;
+
+    void echo(const char *text, const size_t length) {
+        output.append(text, length);
+    }
+
+    void flush() {
+        size_t written = 0;
+        while (written < output.size()) {
+            const ssize_t n = write(STDOUT_FILENO, output.data() + written, output.size() - written);
+            if (n <= 0) break;
+            written += static_cast<size_t>(n);
+        }
+        output.clear();
+    }
+
+    bool get(char &c) {
+        if (next == size) {
+            flush();
+            size = read(STDIN_FILENO, data, sizeof(data));
+            next = 0;
+            if (size <= 0) {
+                size = 0;
+                return false;
+            }
+        }
+        c = data[next++];
+        return true;
+    }
+};
+
+inline TerminalInput terminal_input;
+
+inline void read_input_c(std::string &line) {
+    TerminalInput &in = terminal_input;
     size_t pos = 0; // Current cursor position
-    size_t length = 0; // Length of the input string in `buffer`
     char c;
     std::string current_input; // Keeps track of the current input for history navigation
+    line.clear();
+
+    // replace the line on screen, e.g. with a history entry
+    auto showLine = [&](const std::string &text) {
+        line = text;
+        pos = line.size();
+        in.echo("\33[2K\r", 5); // Clear line
+        in.echo(line.data(), line.size());
+    };
 
     while (true) {
-        if (read(STDIN_FILENO, &c, 1) != 1) break; // Read a single character
+        if (!in.get(c)) break; // Read a single character
 
         if (debug_enabled) printf("DEBUG: Read character: %c (0x%02X)\n", c, c);
 
         // Handle Enter (complete the line input)
         if (c == '\n' || c == '\r') {
-            write(STDOUT_FILENO, "\n", 1);
-            buffer[length] = '\0'; // Null-terminate the input
+            in.echo("\n", 1);
 
-            if (length > 0) {
-                history.push_back(std::string(buffer)); // Save input to history
+            // pasted lines would flood the history
+            if (!line.empty() && !in.pasting) {
+                history.push_back(line); // Save input to history
                 if (history.size() > MAX_HISTORY) history.erase(history.begin()); // Limit history
             }
 
@@ -78,321 +142,157 @@ inline void read_input_c(char *buffer, size_t max_length) {
         }
 
         // Handle Backspace
-        if (c == 127 || c == 8) {
+        if ((c == 127 || c == 8) && !in.pasting) {
             // Backspace or Ctrl-H
             if (pos > 0) {
                 pos--;
-                length--;
-                memmove(buffer + pos, buffer + pos + 1, length - pos); // Remove the char at `pos`
-                buffer[length] = '\0';
+                line.erase(pos, 1); // Remove the char at `pos`
 
                 // Update screen
-                write(STDOUT_FILENO, "\b", 1); // Move cursor back
-                write(STDOUT_FILENO, &buffer[pos], length - pos); // Redraw the rest of the line
-                write(STDOUT_FILENO, " ", 1); // Erase extra character on screen
-                write(STDOUT_FILENO, "\b", 1); // Move cursor back one space
-                for (size_t i = pos; i < length; i++) write(STDOUT_FILENO, "\b", 1); // Place cursor correctly
+                in.echo("\b", 1); // Move cursor back
+                in.echo(line.data() + pos, line.size() - pos); // Redraw the rest of the line
+                in.echo(" \b", 2); // Erase extra character on screen, move cursor back one space
+                for (size_t i = pos; i < line.size(); i++) in.echo("\b", 1); // Place cursor correctly
             }
             continue;
         }
 
-        // Handle Arrow Keys
+        // Handle Arrow Keys and the bracketed paste markers
         if (c == 27) {
-            // Escape sequence
-            char seq[2];
-            if (read(STDIN_FILENO, seq, 2) == 2) {
-                if (seq[0] == '[') {
-                    switch (seq[1]) {
-                        case 'A': // Up - Previous history
-                            if (!history.empty() && history_index + 1 < (int) history.size()) {
-                                if (history_index == -1) current_input = std::string(buffer, length);
-                                // Save current input
-                                history_index++;
-                                strncpy(buffer, history[history.size() - 1 - history_index].c_str(), max_length - 1);
-                                length = strlen(buffer);
-                                pos = length;
-                                buffer[length] = '\0';
-                                write(STDOUT_FILENO, "\33[2K\r", 4); // Clear line
-                                write(STDOUT_FILENO, buffer, length); // Display history item
-                            }
-                            continue;
-                        case 'B': // Down - Next history
-                            if (history_index > 0) {
-                                history_index--;
-                                strncpy(buffer, history[history.size() - 1 - history_index].c_str(), max_length - 1);
-                            } else if (history_index == 0) {
-                                history_index = -1;
-                                strncpy(buffer, current_input.c_str(), max_length - 1);
-                            }
-                            length = strlen(buffer);
-                            pos = length;
-                            buffer[length] = '\0';
-                            write(STDOUT_FILENO, "\33[2K\r", 4); // Clear line
-                            write(STDOUT_FILENO, buffer, length); // Display history item
-                            continue;
-                        case 'D': // Left - Move cursor left
-                            if (pos > 0) {
-                                write(STDOUT_FILENO, "\033[D", 3); // Move cursor left
-                                pos--;
-                            }
-                            continue;
-                        case 'C': // Right - Move cursor right
-                            if (pos < length) {
-                                write(STDOUT_FILENO, "\033[C", 3); // Move cursor right
-                                pos++;
-                            }
-                            continue;
-                    }
+            // Escape sequence, CSI is ESC [ parameters intermediates final (0x40-0x7E)
+            char next;
+            if (!in.get(next)) break;
+            if (next == 'O') {
+                in.get(next); // SS3, one final byte
+                continue;
+            }
+            if (next != '[') continue; // Alt + key
+
+            std::string parameters;
+            char finalByte = 0;
+            while (in.get(next)) {
+                if (next >= 0x40 && next <= 0x7E) {
+                    finalByte = next;
+                    break;
                 }
+                if (next < 0x20 || next > 0x3F) break; // not a CSI sequence, dropped
+                parameters += next;
+            }
+
+            // ESC [200~ starts a paste, ESC [201~ ends it
+            if (finalByte == '~' && parameters == "200") {
+                in.pasting = true;
+                continue;
+            }
+            if (finalByte == '~' && parameters == "201") {
+                in.pasting = false;
+                continue;
+            }
+            if (in.pasting || !parameters.empty()) continue; // Insert, modified keys ...
+
+            switch (finalByte) {
+                case 'A': // Up - Previous history
+                    if (!history.empty() && history_index + 1 < (int) history.size()) {
+                        if (history_index == -1) current_input = line; // Save current input
+                        history_index++;
+                        showLine(history[history.size() - 1 - history_index]); // Display history item
+                    }
+                    break;
+                case 'B': // Down - Next history
+                    if (history_index > 0) {
+                        history_index--;
+                        showLine(history[history.size() - 1 - history_index]);
+                    } else if (history_index == 0) {
+                        history_index = -1;
+                        showLine(current_input);
+                    }
+                    break;
+                case 'D': // Left - Move cursor left
+                    if (pos > 0) {
+                        in.echo("\033[D", 3); // Move cursor left
+                        pos--;
+                    }
+                    break;
+                case 'C': // Right - Move cursor right
+                    if (pos < line.size()) {
+                        in.echo("\033[C", 3); // Move cursor right
+                        pos++;
+                    }
+                    break;
+                default:
+                    break;
             }
             continue;
         }
 
-        if (c == 1) {
+        if (c == 1 && !in.pasting) {
             // Ctrl+A - Move to start of line
             while (pos > 0) {
-                write(STDOUT_FILENO, "\033[D", 3); // Move left
+                in.echo("\033[D", 3); // Move left
                 pos--;
             }
             continue;
         }
 
-        if (c == 5) {
+        if (c == 5 && !in.pasting) {
             // Ctrl+E - Move to end of line
-            while (pos < length) {
-                write(STDOUT_FILENO, "\033[C", 3); // Move right
+            while (pos < line.size()) {
+                in.echo("\033[C", 3); // Move right
                 pos++;
             }
             continue;
         }
 
-        // Handle Normal Character Input
-        if (length < max_length - 1) {
-            // Shift the buffer to the right starting from `pos`
-            memmove(buffer + pos + 1, buffer + pos, length - pos);
-            buffer[pos] = c; // Insert character at cursor
-            length++;
-            pos++;
+        // Handle Normal Character Input, pasted tabs and other controls read as spaces
+        if (in.pasting && (static_cast<unsigned char>(c) < ' ' || c == 127)) c = ' ';
+        line.insert(pos, 1, c); // Insert character at cursor, the line grows as needed
+        pos++;
 
-            // Redraw updated input to the screen
-            write(STDOUT_FILENO, &buffer[pos - 1], length - pos + 1); // Write rest of the string
-            for (size_t i = pos; i < length; i++) write(STDOUT_FILENO, "\b", 1); // Move cursor back to correct position
-        }
+        // Redraw updated input to the screen
+        in.echo(line.data() + pos - 1, line.size() - pos + 1); // Write rest of the string
+        for (size_t i = pos; i < line.size(); i++) in.echo("\b", 1); // Move cursor back to correct position
     }
+    in.flush();
 }
 
 // Wrapper function to replace std::getline with read_input_c
 inline std::istream &custom_getline(std::istream &input, std::string &line) {
-    constexpr size_t MAX_INPUT_LENGTH = 1024;
-    char buffer[MAX_INPUT_LENGTH];
-
     if (!input.good()) return input; // Handle stream errors
 
     // Use your custom terminal input function
-    read_input_c(buffer, MAX_INPUT_LENGTH);
-
-    // Convert buffer to std::string
-    line = std::string(buffer);
+    read_input_c(line);
 
     return input;
 }
 
-void skip_whitespace(const char **input) {
-    while (**input && isspace(**input)) {
-        (*input)++;
-    }
-}
-
-
-int is_float(const char *str) {
-    int has_dot = 0, has_exp = 0;
-    int seen_digit_before_exp = 0, seen_digit_after_exp = 0;
-
-    // Handle optional leading sign
-    if (*str == '-' || *str == '+') {
-        str++;
-    }
-
-    while (*str) {
-        if (*str == '.') {
-            if (has_dot || has_exp) {
-                return 0; // Invalid: more than one dot or dot after exponent
-            }
-            has_dot = 1;
-        } else if (*str == 'e' || *str == 'E') {
-            if (has_exp || !seen_digit_before_exp) {
-                return 0; // Invalid: more than one exponent or no digits before exponent
-            }
-            has_exp = 1;
-        } else if (*str == '-' || *str == '+') {
-            if (*(str - 1) != 'e' && *(str - 1) != 'E') {
-                return 0; // Invalid: sign not immediately after exponent
-            }
-        } else if (isdigit(*str)) {
-            if (has_exp) {
-                seen_digit_after_exp = 1; // Keeping track of digits after 'e/E'
-            } else {
-                seen_digit_before_exp = 1; // Keeping track of digits before 'e/E'
-            }
-        } else {
-            return 0; // Invalid character
-        }
-        str++;
-    }
-    return (has_dot || has_exp) && seen_digit_before_exp && (!has_exp || seen_digit_after_exp);
-}
-
-Token get_next_token(const char **input) {
-    Token token = {TOKEN_UNKNOWN, {0}};
-    skip_whitespace(input);
-
-    if (**input == '\0') {
-        token.type = TOKEN_END;
-        return token;
-    }
-
-    int i = 0;
-    char temp[MAX_TOKEN_LENGTH] = {0};
-    while (**input && !isspace(**input) && i < MAX_TOKEN_LENGTH - 1) {
-        temp[i++] = *(*input)++;
-    }
-    temp[i] = '\0';
-
-    // Check for compilation/interpreting tokens
-    if (strcmp(temp, ":") == 0 || strcmp(temp, "]") == 0) {
-        token.type = TOKEN_COMPILING;
-    } else if (strcmp(temp, ";") == 0 || strcmp(temp, "[") == 0) {
-        token.type = TOKEN_INTERPRETING;
-    }
-    // Handle words ending in quotes
-    else if (temp[i - 1] == '"') {
-        temp[i] = '\0'; // Remove trailing " from word
-        token.type = TOKEN_WORD;
-        strncpy(token.value, temp, MAX_TOKEN_LENGTH - 1);
-        (*input)--; // Backtrack so the " starts a new string literal
-    }
-    // Detect floating numbers
-    else if (is_float(temp)) {
-        token.type = TOKEN_FLOAT;
-        token.float_value = atof(temp);
-    }
-    // Detect integer numbers
-    else if (is_number(temp)) {
-        token.type = TOKEN_NUMBER;
-        token.int_value = parseNumber(temp);
-    }
-    // Handle regular words
-    else {
-        token.type = TOKEN_WORD;
-        strncpy(token.value, temp, MAX_TOKEN_LENGTH - 1);
-    }
-    return token;
-}
-
-
-Token get_string_token(const char **input) {
-    Token token = {TOKEN_STRING, {0}};
-    (*input)++; // Consume opening "
-    if (**input == ' ') {
-        (*input)++; // Consume that one space
-    }
-    int i = 0;
-    while (**input && **input != '"' && i < MAX_TOKEN_LENGTH - 1) {
-        token.value[i++] = *(*input)++;
-    }
-    if (**input == '"') {
-        (*input)++; // Consume closing quote
-    }
-    token.value[i] = '\0';
-    return token;
-}
-
-inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
-    const char *cursor = input;
-    int token_count = 0;
-    Token token;
-
-    // reset all tokens
-    for (int i = 0; i < MAX_TOKENS; i++) {
-        tokens[i].type = TOKEN_END;
-        tokens[i].value[0] = '\0';
-        tokens[i].int_value = 0;
-        tokens[i].float_value = 0;
-    }
-
-    while ((token = get_next_token(&cursor)).type != TOKEN_END && token_count < MAX_TOKENS) {
-        if (token.type == TOKEN_WORD && *cursor == '"') {
-            tokens[token_count++] = token;
-            token = get_string_token(&cursor);
-        }
-        tokens[token_count++] = token;
-    }
-
-    tokens[token_count].type = TOKEN_END; // Mark end of tokens
-    return token_count;
-}
-
- inline void handleCompilerTokenizedWord(int &index, Token (*tokens)[MAX_TOKENS]) {
-
-
-    // on entry we should have TOKEN_COMPILING at index
-    if ( (*tokens)[index].type != TOKEN_COMPILING) {
-        throw std::runtime_error("Compiler Error: invalid token: " + std::to_string((*tokens)[index].type));
-    }
-
-    TransientStringManager& tsm = TransientStringManager::instance();
-    tsm.beginFunction();
-
-    // skip to new word name
-    index++;
-    std::string wordName = (*tokens)[index].value;
-    logging = jc.logging; // Use a single consistent logging variable
-    printf("\nCompiling word: [%s]\n", wordName.c_str());
-
-    // Prevent recompiling an existing word
-    if (d.findWord(wordName.c_str()) != nullptr) {
-        if (logging) printf("Compiler: word already exists: %s\n", wordName.c_str());
-        jc.resetContext();
-        throw std::runtime_error("Compiler Error: word already exists: " + wordName);
-    }
-
-    // Check if this word is being traced
-    bool wordLogging = (tracedWords.find(wordName) != tracedWords.end());
-    if (wordLogging) {
-        printf("\nCompiling word: [%s] with tracing enabled.\n", wordName.c_str());
-    }
-
-    // Get singleton JIT context and reset it for new word compilation
-    JitContext &jc = JitContext::getInstance();
-    jc.resetContext();
-
-    // Start compiling the new word
-    JitGenerator::genPrologue();
-
-
-
-    // Process tokens until end or exit condition (TOKEN_END or TOKEN_COMPILING)
-    index++;
-
-    while (index < MAX_TOKENS) {
-        auto &token = (*tokens)[index];
+// Generate code for the tokens from index up to last, stopping early at the end
+// of the source, at ':' or at ';'. index is left on the token that stopped it,
+// or one past last.
+inline void compileTokens(int &index, TokenStream &tokens, const int last) {
+    while (index <= last) {
+        const Token token = tokens[index];
         auto type = token.type;
 
-        if (type == TOKEN_COMPILING || type == TOKEN_END) {
+        if (type == TOKEN_COMPILING || type == TOKEN_END || (type == TOKEN_INTERPRETING && token.view() == ";")) {
             break;
         }
 
         if (logging) {
-            printf("Processing token at index %d: [%s] (type=%d)\n", index, token.value, type);
+            printf("Processing token at index %d: [%.*s] (type=%d)\n", index, static_cast<int>(token.length),
+                   token.text, type);
         }
 
         switch (type) {
             case TOKEN_WORD: {
-                std::string word = token.value;
+                std::string word = token.str();
 
                 if (logging) printf("Processing WORD: %s\n", word.c_str());
 
-                auto *fword = d.findWord(word.c_str());
+                ForthWord *fword;
+                {
+                    CompileTimer timer(jc.compileTimings, jc.compileTimings.lookupNs);
+                    fword = d.findWord(token.view());
+                }
 
 
                 if (fword) {
@@ -402,14 +302,14 @@ inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
                         exec(fword->generatorFunc);
                     } else if (fword->compiledFunc) {
                         if (logging) printf("Generating call for compiled function of word: %s\n", word.c_str());
-                        JitGenerator::genCall(fword->compiledFunc);
+                        JitGenerator::genCallWord(fword);
                     } else if (fword->immediateFunc) {
                         if (logging) printf("Running immediate function of word: %s\n", word.c_str());
 
                         // Handle immediate functions
                         jc.pos_next_word = index;
                         jc.pos_last_word = 0;
-                        jc.next_token = (*(tokens))[index + 1];
+                        jc.next_token = tokens[index + 1];
                         exec(fword->immediateFunc);
 
                         // Handle modified index from immediate function
@@ -439,7 +339,7 @@ inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
                 uint64_t number = token.int_value;
                 jc.uint64_A = number;
                 JitGenerator::genPushLong();
-                if (logging) printf("Generated code for number: %d\n", token.int_value);
+                if (logging) printf("Generated code for number: %lld\n", static_cast<long long>(token.int_value));
                 break;
             }
             case TOKEN_FLOAT: {
@@ -454,12 +354,13 @@ inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
             case TOKEN_UNKNOWN: {
                 if (logging) printf("Processing UNKNOWN token.\n");
                 jc.resetContext();
-                throw std::runtime_error("Unknown token encountered: " + std::string(token.value));
+                throw std::runtime_error("Unknown token encountered: " + token.str());
             }
             case TOKEN_INTERPRETING:
             case TOKEN_COMPILING:
                 // Nothing specific needed here, break out of loop if encountered
-                if (logging) printf("Unexpected COMPILING/INTERPRETING token: [%s]\n", token.value);
+                if (logging) printf("Unexpected COMPILING/INTERPRETING token: [%.*s]\n",
+                                    static_cast<int>(token.length), token.text);
                 break;
             default:
                 if (logging) printf("Unhandled token type: [%d]\n", type);
@@ -469,12 +370,73 @@ inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
         // Increment index for the next token
         index++;
     }
+}
+
+
+// Compile the definition that starts at the ':' token at index.
+// Returns the new code, the caller decides when it is added to the dictionary,
+// which lets the compile pool build definitions on worker threads.
+inline ForthFunction compileTokenizedDefinition(int &index, TokenStream &tokens, std::string &wordName) {
+
+
+    // on entry we should have TOKEN_COMPILING at index
+    if (tokens[index].type != TOKEN_COMPILING) {
+        throw std::runtime_error("Compiler Error: invalid token: " + std::to_string(tokens[index].type));
+    }
+
+    TransientStringManager& tsm = TransientStringManager::instance();
+    tsm.beginFunction();
+    GlobalStringManager::Capture stringCapture;
+
+    // skip to new word name
+    index++;
+    wordName = tokens[index].str();
+    logging = jc.logging; // Use a single consistent logging variable
+    if (echo_enabled) printf("\nCompiling word: [%s]\n", wordName.c_str());
+
+    // Prevent recompiling an existing word, unless callers reach it through its slot
+    ForthWord *existing = d.findWord(wordName.c_str());
+    if (existing != nullptr && !(jc.optIndirectCalls && existing->isRedefinable())) {
+        if (logging) printf("Compiler: word already exists: %s\n", wordName.c_str());
+        jc.resetContext();
+        throw std::runtime_error("Compiler Error: word already exists: " + wordName);
+    }
+    jc.redefining = existing;
+    // cleared however the compile ends, left set after an error later callers of
+    // the word would call its old code directly
+    struct ClearRedefining {
+        ~ClearRedefining() { jc.redefining = nullptr; }
+    } clearRedefining;
+
+    // Check if this word is being traced
+    bool wordLogging = (tracedWords.find(wordName) != tracedWords.end());
+    if (wordLogging) {
+        printf("\nCompiling word: [%s] with tracing enabled.\n", wordName.c_str());
+    }
+
+    // Get singleton JIT context and reset it for new word compilation
+    JitContext &jc = JitContext::getInstance();
+    jc.resetContext();
+
+    // Start compiling the new word
+    JitGenerator::genPrologue();
+    if (jc.wordStats) {
+        jc.wordStats->setName(wordName);
+    }
+    if (jc.traceId) {
+        ExecutionTrace::getInstance().setName(jc.traceId, wordName);
+    }
+
+
+
+    // Process tokens until end or exit condition (TOKEN_END, TOKEN_COMPILING or ';')
+    index++;
+    compileTokens(index, tokens, INT_MAX);
 
     // Finalize compiled word
     JitGenerator::genEpilogue();
     const ForthFunction f = JitGenerator::endGeneration();
-
-    d.addWord(wordName.c_str(), nullptr, f, nullptr, nullptr, "");
+    jc.attachStrings(reinterpret_cast<void *>(f), stringCapture.finish());
 
     if (logging || wordLogging) {
         printf("Compiler: Successfully compiled word: %s\n", wordName.c_str());
@@ -482,48 +444,156 @@ inline int tokenize_forth(const char *input, Token tokens[MAX_TOKENS]) {
     }
 
     tsm.endFunction();
+    return f;
 }
 
 
-inline void interpreterProcessWordTokenized(const Token &token, int &index, Token (*tokens)[MAX_TOKENS]) {
+// Add a compiled definition to the dictionary, or retarget the existing word
+// when indirect calls allow it.
+inline void publishDefinition(const std::string &wordName, const ForthFunction f) {
+    ForthWord *existing = d.findWord(wordName.c_str());
+    if (existing == nullptr) {
+        d.addWord(wordName.c_str(), nullptr, f, nullptr, nullptr, "");
+        d.getLatestWord()->flags |= WORD_COLON;
+        return;
+    }
+    if (!(jc.optIndirectCalls && existing->isRedefinable())) {
+        jc.releaseCode(reinterpret_cast<void *>(f));
+        throw std::runtime_error("Compiler Error: word already exists: " + wordName);
+    }
+    d.redefineWord(existing, f);
+}
+
+
+inline void handleCompilerTokenizedWord(int &index, TokenStream &tokens) {
+    std::string wordName;
+    const uint64_t start = jc.compileTimings.enabled ? CompileTimings::now() : 0;
+    const uint64_t tokenizedBefore = jc.compileTimings.tokenizeNs;
+    const ForthFunction f = compileTokenizedDefinition(index, tokens, wordName);
+    if (jc.compileTimings.enabled) {
+        // the stream pulls the definition's tokens while it compiles, that time is
+        // already in tokenizeNs and is left out here
+        const uint64_t tokenized = jc.compileTimings.tokenizeNs - tokenizedBefore;
+        const uint64_t elapsed = CompileTimings::now() - start - tokenized;
+        jc.compileTimings.compileNs += elapsed;
+        jc.compileTimings.definitionNs.push_back(elapsed);
+    }
+    publishDefinition(wordName, f);
+}
+
+
+// Compile the tokens from index up to last into a word that is not added to the
+// dictionary, for code that runs without a definition. The caller releases the code.
+inline ForthFunction compileAnonymous(int index, TokenStream &tokens, const int last) {
+    TransientStringManager &tsm = TransientStringManager::instance();
+    tsm.beginFunction();
+    GlobalStringManager::Capture stringCapture;
+    logging = jc.logging;
+
+    jc.resetContext();
+    // left out of *STATS and *TRACE, each one would take a record that is never reused
+    const bool wordStats = jc.optWordStats;
+    const bool trace = jc.optTrace;
+    jc.optWordStats = jc.optTrace = false;
+    JitGenerator::genPrologue();
+    jc.optWordStats = wordStats;
+    jc.optTrace = trace;
+    compileTokens(index, tokens, last);
+    JitGenerator::genEpilogue();
+    const ForthFunction f = JitGenerator::endGeneration();
+    jc.attachStrings(reinterpret_cast<void *>(f), stringCapture.finish());
+    tsm.endFunction();
+    return f;
+}
+
+
+// How a word changes control flow nesting, +1 opens a structure, -1 closes one.
+inline int controlNesting(const std::string_view word) {
+    static const std::unordered_set<std::string> opens = {"if", "begin", "do", "?do", "case"};
+    static const std::unordered_set<std::string> closes = {"then", "until", "repeat", "again", "loop", "+loop", "endcase"};
+    const std::string name = to_lower(std::string(word));
+    if (opens.contains(name)) return 1;
+    if (closes.contains(name)) return -1;
+    return 0;
+}
+
+
+// IF, BEGIN, DO and CASE are compile only. Met at the top level, the structure they
+// open is compiled into a temporary word that runs once and is released, so scripts
+// can loop without wrapping the loop in a definition. The values before the structure
+// have already been pushed, the temporary word takes them from the stack.
+// Returns false when the structure is not closed in this source or contains a
+// definition, the caller reports the word as before.
+inline bool autoJitControlFlow(int &index, TokenStream &tokens) {
+    if (controlNesting(tokens[index].view()) != 1) {
+        return false;
+    }
+
+    // find the token that closes the structure
+    int last = index;
+    for (int depth = 0;; last++) {
+        const Token token = tokens[last];
+        if (token.type == TOKEN_END || token.type == TOKEN_COMPILING || token.type == TOKEN_INTERPRETING) {
+            return false;
+        }
+        if (token.type == TOKEN_WORD) depth += controlNesting(token.view());
+        if (depth == 0) break;
+    }
+
+    const ForthFunction f = compileAnonymous(index, tokens, last);
+
+    // queued before it runs, the code goes at the next safe point even when an
+    // error longjmps out of it
+    jc.releaseCode(reinterpret_cast<void *>(f));
+    index = last;
+    exec(f);
+    return true;
+}
+
+
+inline void interpreterProcessWordTokenized(const Token &token, int &index, TokenStream &tokens) {
     ForthWord *fword = nullptr;
 
     switch (token.type) {
         case TOKEN_WORD:
-            // Handle word tokens, `value` is used for string/word storage
-            if (debug_enabled) printf("Processing WORD: %s\n", token.value);
-            fword = d.findWord(token.value);
+            // Handle word tokens, the text is a view into the source
+            if (debug_enabled) printf("Processing WORD: %.*s\n", static_cast<int>(token.length), token.text);
+            fword = d.findWord(token.view());
             if (fword) {
                 if (fword->compiledFunc) {
-                    if (debug_enabled) printf("Calling word: %s\n", token.value);
+                    if (debug_enabled) printf("Calling word: %.*s\n", static_cast<int>(token.length), token.text);
                     exec(fword->compiledFunc);
                 } else if (fword->terpFunc) // immediate word
                 {
-                    if (debug_enabled) printf("Running interpreter immediate word: %s\n", token.value);
+                    if (debug_enabled) printf("Running interpreter immediate word: %.*s\n",
+                                              static_cast<int>(token.length), token.text);
                     jc.pos_next_word = index;
-                    jc.next_token = (*(tokens))[index + 1];
-                    if (debug_enabled) printf("Next token: [%s]\n", (*(tokens))[index + 1].value);
+                    jc.next_token = tokens[index + 1];
+                    if (debug_enabled) printf("Next token: [%.*s]\n", static_cast<int>(jc.next_token.length),
+                                              jc.next_token.text);
                     exec(fword->terpFunc);
                     index = jc.pos_last_word;
+                } else if (jc.optAutoJit && autoJitControlFlow(index, tokens)) {
+                    if (debug_enabled) printf("Ran control flow as a temporary word\n");
                 } else {
                     if (debug_enabled)
-                        std::cout << "Error: Word [" << token.value <<
+                        std::cout << "Error: Word [" << token.view() <<
                                 "] found but cannot be executed.\n";
-                    d.displayWord(token.value);
+                    d.displayWord(token.str());
                     throw std::runtime_error("Cannot execute word");
                 }
             } else {
                 if (debug_enabled)
-                    std::cout << "Error: Unknown or uncompilable word: [" << token.value << "]" <<
+                    std::cout << "Error: Unknown or uncompilable word: [" << token.view() << "]" <<
                             std::endl;
-                throw std::runtime_error("Unknown word: " + std::string(token.value));
+                throw std::runtime_error("Unknown word: " + token.str());
             }
             break;
 
         case TOKEN_COMPILING:
-            printf("Processing COMPILING: %s\n", token.value);
+            if (echo_enabled) printf("Processing COMPILING: %.*s\n", static_cast<int>(token.length), token.text);
             handleCompilerTokenizedWord(index, tokens);
-
+            break;
 
         case TOKEN_NUMBER:
             // Handle integers
@@ -540,15 +610,15 @@ inline void interpreterProcessWordTokenized(const Token &token, int &index, Toke
 
         case TOKEN_STRING:
             // Handle string literal tokens
-            if (debug_enabled) printf("Processing STRING: \"%s\"\n", token.value);
+            if (debug_enabled) printf("Processing STRING: \"%.*s\"\n", static_cast<int>(token.length), token.text);
 
             break;
 
         case TOKEN_UNKNOWN:
             // Handle unknown tokens if necessary
             if (debug_enabled) printf("Processing UNKNOWN token.\n");
-            if (logging) std::cout << "Error: Unknown or uncompilable word: [" << token.value << "]" << std::endl;
-            throw std::runtime_error("Unknown word: " + std::string(token.value));
+            if (logging) std::cout << "Error: Unknown or uncompilable word: [" << token.view() << "]" << std::endl;
+            throw std::runtime_error("Unknown word: " + token.str());
             break;
 
         case TOKEN_END:
@@ -563,18 +633,256 @@ inline void interpreterProcessWordTokenized(const Token &token, int &index, Toke
 }
 
 
-inline void interpreter(const std::string &sourceCode) {
-    int count = tokenize_forth(sourceCode.c_str(), tokens);
-    // print_token_list(tokens, count);
+// Text run from inside a word gets its own token stream, and the position an
+// immediate word reads from. The caller's resume when the scope ends.
+struct NestedTokenStream {
+    TokenStream outer = std::exchange(tokens, TokenStream{});
+    size_t posNextWord = jc.pos_next_word;
+    size_t posLastWord = jc.pos_last_word;
+    Token nextToken = jc.next_token;
+
+    NestedTokenStream() = default;
+    NestedTokenStream(const NestedTokenStream &) = delete;
+    NestedTokenStream &operator=(const NestedTokenStream &) = delete;
 
+    ~NestedTokenStream() {
+        tokens = std::move(outer);
+        jc.pos_next_word = posNextWord;
+        jc.pos_last_word = posLastWord;
+        jc.next_token = nextToken;
+    }
+};
+
+
+inline void interpreter(const std::string_view sourceCode) {
+    NestedTokenStream nested;
+    tokens.open(sourceCode, &jc.compileTimings);
 
-    int i = 0;
-    while (i < count) {
-        // Pass the token, index, and full token array to the processing function
-        interpreterProcessWordTokenized(tokens[i], i, &tokens);
-        i++;
+    for (int i = 0; tokens[i].type != TOKEN_END; i++) {
+        // Pass the token, index, and the stream for immediate words to read ahead
+        interpreterProcessWordTokenized(tokens[i], i, tokens);
+        tokens.discardBefore(i + 1);
     }
+}
+
 
+// Whether every token of text compiles to the same effect it has when interpreted:
+// numbers, words that generate or call code, and closed control structures.
+// Definitions and interpret only words (VALUE, VARIABLE, SEE ...) are left out, as
+// are words that change BASE: interpreted, the literals after them are read in the
+// new BASE, compiled, every literal is read before any of it runs.
+inline bool compilesLikeInterpreted(const std::string_view text) {
+    static const std::unordered_set<std::string> tokenizerState = {"base", "hex", "decimal"};
+    TokenStream scan;
+    scan.open(text);
+    int depth = 0;
+    for (size_t i = 0; scan[i].type != TOKEN_END; i++) {
+        scan.discardBefore(i);
+        const Token token = scan[i];
+        if (token.type == TOKEN_COMPILING || token.type == TOKEN_INTERPRETING || token.type == TOKEN_UNKNOWN) {
+            return false;
+        }
+        if (token.type != TOKEN_WORD) continue;
+        if (tokenizerState.contains(to_lower(token.str()))) return false;
+        const ForthWord *word = d.findWord(token.view());
+        if (word == nullptr || word->state == ForthWordState::INTERPRET_ONLY_IMMEDIATE ||
+            !(word->generatorFunc || word->compiledFunc || word->immediateFunc)) {
+            return false;
+        }
+        depth += controlNesting(token.view());
+        if (depth < 0) return false;
+    }
+    return depth == 0;
+}
+
+
+/**
+ * EvaluateCache
+ *  - EVALUATE interprets a string the first time it sees it. From the second
+ *    time on the string runs as an anonymous word compiled from it, when it
+ *    compiles to the same effect (see compilesLikeInterpreted).
+ *  - Entries are keyed by the text and hold the dictionary generation and BASE
+ *    they were compiled under, a change to either recompiles on next use.
+ *  - Bounded: when full, every entry is dropped and its code released.
+ */
+class EvaluateCache {
+public:
+    static EvaluateCache &getInstance() {
+        static EvaluateCache instance;
+        return instance;
+    }
+
+    EvaluateCache(const EvaluateCache &) = delete;
+    EvaluateCache &operator=(const EvaluateCache &) = delete;
+
+    // The compiled text, or nullptr when it is to be interpreted this time.
+    ForthFunction find(const std::string_view text) {
+        const uint64_t generation = d.getGeneration();
+        auto it = entries_.find(text);
+        if (it == entries_.end()) {
+            if (entries_.size() >= MAX_ENTRIES) clear();
+            entries_.emplace(std::string(text), Entry{generation, numberBase});
+            return nullptr;
+        }
+
+        Entry &entry = it->second;
+        if (entry.generation != generation || entry.base != numberBase) {
+            release(entry);
+            entry = Entry{generation, numberBase};
+            return nullptr;
+        }
+        if (entry.code == nullptr && entry.compilable && ++entry.seen >= 2) {
+            entry.compilable = compilesLikeInterpreted(text);
+            try {
+                if (entry.compilable) entry.code = compile(text);
+            } catch (const std::exception &) {
+                entry.compilable = false; // interpreting it reports the error
+            }
+        }
+        return entry.code;
+    }
+
+    void clear() {
+        for (auto &[text, entry]: entries_) {
+            release(entry);
+        }
+        entries_.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return entries_.size();
+    }
+
+private:
+    EvaluateCache() = default;
+
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    struct Entry {
+        uint64_t generation;
+        int64_t base;
+        uint32_t seen = 1;
+        bool compilable = true;
+        ForthFunction code = nullptr;
+    };
+
+    // lets find() look up a string_view without building a std::string
+    struct TextHash {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view text) const {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    static ForthFunction compile(const std::string_view text) {
+        NestedTokenStream nested;
+        tokens.open(text, &jc.compileTimings);
+        return compileAnonymous(0, tokens, INT_MAX);
+    }
+
+    static void release(Entry &entry) {
+        if (entry.code) jc.releaseCode(reinterpret_cast<void *>(entry.code));
+        entry.code = nullptr;
+    }
+
+    std::unordered_map<std::string, Entry, TextHash, std::equal_to<> > entries_;
+};
+
+
+// EVALUATE ( addr len -- ) interpret the string, nested in whatever is running.
+inline void evaluate(const std::string_view text) {
+    if (const ForthFunction f = EvaluateCache::getInstance().find(text)) {
+        exec(f);
+        return;
+    }
+    interpreter(text);
+}
+
+inline void prim_evaluate() {
+    const uint64_t length = sm.popDS();
+    const auto *text = reinterpret_cast<const char *>(sm.popDS());
+    evaluate(std::string_view(text, length));
+}
+
+inline void genEvaluate() {
+    if (!jc.assembler) {
+        throw std::runtime_error("gen_evaluate: Assembler not initialized");
+    }
+
+    auto &a = *jc.assembler;
+    a.comment(" ; ----- evaluate");
+    a.push(asmjit::x86::rdi);
+    a.call(asmjit::imm(reinterpret_cast<void *>(prim_evaluate)));
+    a.pop(asmjit::x86::rdi);
+}
+
+
+// Compile a batch of independent definitions on the compile pool.
+// The words are added to the dictionary in source order, as if compiled one by one.
+inline void compileDefinitionsInParallel(std::vector<std::string_view> &batch) {
+    if (batch.empty()) {
+        return;
+    }
+    if (batch.size() == 1) {
+        interpreter(batch.front());
+        batch.clear();
+        return;
+    }
+
+    CompilePool &pool = CompilePool::getInstance();
+    const JitContext &mainContext = jc;
+
+    std::vector<std::future<std::pair<std::string, ForthFunction> > > results;
+    results.reserve(batch.size());
+    for (const auto &source: batch) {
+        results.push_back(pool.submit([&mainContext, &source] {
+            // runs on a worker, jc and tokens are the worker's own
+            jc.copyOptionsFrom(mainContext);
+            tokens.open(source, &jc.compileTimings);
+            int index = 0;
+            std::string wordName;
+            ForthFunction f = compileTokenizedDefinition(index, tokens, wordName);
+            return std::make_pair(wordName, f);
+        }));
+    }
+
+    // The workers look words up while they compile, so nothing is added to the
+    // dictionary until every job has finished.
+    struct Compiled {
+        std::string wordName;
+        ForthFunction f = nullptr;
+        std::exception_ptr error;
+    };
+    std::vector<Compiled> compiled(results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        try {
+            std::tie(compiled[i].wordName, compiled[i].f) = results[i].get();
+        } catch (...) {
+            compiled[i].error = std::current_exception();
+        }
+    }
+    batch.clear();
+
+    // Publish in order, after the first error the remaining code is released.
+    std::exception_ptr error;
+    for (auto &[wordName, f, failure]: compiled) {
+        if (!error && failure) error = failure;
+        if (f == nullptr) continue;
+        if (error) {
+            jc.releaseCode(reinterpret_cast<void *>(f));
+            continue;
+        }
+        try {
+            publishDefinition(wordName, f);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
 
@@ -583,73 +891,155 @@ inline bool startup_loaded = false;
 
 // Function to interpret multiple statements and functions in the given text
 // use when loading forth from a file etc.
-inline void interpretText(const std::string &text) {
-    std::istringstream stream(text);
-    std::string line;
-    std::string accumulated_input;
-    bool compiling = false;
+inline void interpretText(const std::string_view text) {
+    if (!jc.optParallelCompile) {
+        // the token stream follows definitions across lines itself
+        interpreter(text);
+        return;
+    }
 
-    while (std::getline(stream, line)) {
-        if (line.empty()) {
+    // With parallel compilation on, a colon definition that contains no other
+    // ':' or ';' is batched, runs of batched definitions compile together.
+    // Everything else is interpreted in source order between the batches.
+    TokenStream scan;
+    scan.openStructure(text);
+    const char *pending = text.data(); // start of the text not yet run or batched
+    const char *textEnd = text.data() + text.size();
+
+    std::vector<std::string_view> batch;
+    std::unordered_set<std::string> batchNames;
+
+    auto flushBatch = [&] {
+        batchNames.clear();
+        compileDefinitionsInParallel(batch);
+    };
+
+    auto runPending = [&](const char *upTo) {
+        const std::string_view code(pending, upTo - pending);
+        pending = upTo;
+        if (code.find_first_not_of(" \t\r\n") == std::string_view::npos) return;
+        flushBatch();
+        interpreter(code);
+    };
+
+    // string literals are their own tokens, a ; inside one is not seen here
+    auto isColon = [](const Token &token) { return token.type == TOKEN_COMPILING && token.view() == ":"; };
+    auto isSemicolon = [](const Token &token) { return token.type == TOKEN_INTERPRETING && token.view() == ";"; };
+
+    for (size_t i = 0; scan[i].type != TOKEN_END; i++) {
+        scan.discardBefore(i);
+        const Token colon = scan[i];
+        if (!isColon(colon)) continue;
+
+        // find the ';' that ends the definition
+        size_t end = i + 2;
+        Token token;
+        while ((token = scan[end]).type != TOKEN_END && !isSemicolon(token) && !isColon(token)) {
+            end++;
+        }
+        if (token.type == TOKEN_END) break;
+        if (isColon(token)) {
+            i = end - 1; // not standalone, left in the pending text
             continue;
         }
 
-        accumulated_input += " " + line; // Accumulate input lines
+        runPending(colon.text);
+        // a definition that uses a word from the batch has to wait for it
+        for (size_t k = i + 2; k < end; k++) {
+            if (const Token word = scan[k]; word.type == TOKEN_WORD && batchNames.contains(to_lower(word.str()))) {
+                flushBatch();
+                break;
+            }
+        }
+        batchNames.insert(to_lower(scan[i + 1].str()));
+        pending = token.text + token.length;
+        batch.emplace_back(colon.text, pending - colon.text);
+        i = end;
+    }
 
-        auto words = split(line);
+    runPending(textEnd);
+    flushBatch();
+}
 
-        for (auto it = words.begin(); it != words.end(); ++it) {
-            const auto &word = *it;
 
-            if (word == ":") {
+// Interpret a stream such as stdin as it arrives. Lines are gathered until no
+// definition or top level control structure is left open, then run, so output
+// appears while the rest of the input is still being read.
+inline void interpretLines(std::istream &in) {
+    std::string line;
+    std::string unit;
+    bool compiling = false;
+    int depth = 0;
+
+    while (std::getline(in, line)) {
+        unit += line;
+        unit += '\n';
+
+        TokenStream scan;
+        scan.openStructure(line);
+        for (size_t i = 0; scan[i].type != TOKEN_END; i++) {
+            scan.discardBefore(i);
+            const Token token = scan[i];
+            if (token.type == TOKEN_COMPILING && token.view() == ":") {
                 compiling = true;
-            } else if (word == ";") {
+            } else if (token.type == TOKEN_INTERPRETING && token.view() == ";") {
                 compiling = false;
-                // printf("Interpret text : [%s]\n", accumulated_input.c_str());
-                interpreter(accumulated_input);
-                accumulated_input.clear();
-                break;
+            } else if (!compiling && token.type == TOKEN_WORD) {
+                depth += controlNesting(token.view());
             }
         }
 
-        if (!compiling) {
-            interpreter(accumulated_input);
-            accumulated_input.clear();
+        if (!compiling && depth <= 0) {
+            interpreter(unit);
+            unit.clear();
+            depth = 0;
+            jc.releasePendingCode();
         }
     }
 
-    // Ensure remaining accumulated input is processed after the loop
-    if (!accumulated_input.empty()) {
-        interpreter(accumulated_input);
-        accumulated_input.clear();
+    // an unterminated definition or structure still runs, and reports its error
+    if (!unit.empty()) {
+        interpreter(unit);
+        jc.releasePendingCode();
     }
 }
 
 
-// Function to load and interpret the start.f file
-inline void slurpIn(const std::string &file_name = "./start.f") {
-    if (startup_loaded) return;
-    startup_loaded = true;
+// Interpret a source file, mapped and tokenized in place.
+inline void includeFile(const std::string &path) {
+    const SourceFile source(path);
+    interpretText(source.text());
+}
 
-    if (std::ifstream file(file_name); !file.is_open()) {
-        throw std::runtime_error("Could not open start.f file.");
+
+// INCLUDE filename, interpreting only
+inline void terpInclude() {
+    const size_t pos = jc.pos_next_word + 1;
+    const Token name = tokens[pos];
+    if (name.type == TOKEN_END) {
+        throw std::runtime_error("INCLUDE: Expected file name");
     }
+    includeFile(name.str());
+    // the included text has run its own words, resume after the file name
+    jc.pos_last_word = pos;
+}
 
-    try {
-        std::ifstream file(file_name);
-        if (!file.is_open()) {
-            throw std::runtime_error("Could not open file.");
-        }
 
-        // Read the entire file content into a string
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string fileContent = buffer.str();
+// Words that need the interpreter itself, registered after add_words.
+inline void add_interpreter_words() {
+    d.addWord("INCLUDE", nullptr, nullptr, nullptr, terpInclude);
+    d.addWord("EVALUATE", genEvaluate, JitGenerator::build_forth(genEvaluate), nullptr, nullptr);
+}
 
-        // Close the file
-        file.close();
 
-        interpretText(fileContent);
+// Function to load and interpret the start.f file
+inline void slurpIn(const std::string &file_name = "./start.f") {
+    if (startup_loaded) return;
+    startup_loaded = true;
+
+    try {
+        includeFile(file_name);
+        jc.releasePendingCode();
     } catch (const std::exception &e) {
         std::cerr << "Runtime error: " << e.what() << std::endl;
         // Reset context and stack as required
@@ -661,6 +1051,7 @@ inline std::string handleSpecialCommands(const std::string &input) {
 
     if (input == "*MEM" || input == "*mem") {
         jc.reportMemoryUsage();
+        reportMemory();
         handled = true;
     } else if (input == "*TESTS" || input == "*tests") {
         run_basic_tests();
@@ -745,6 +1136,211 @@ inline bool processLoopCheckCommands(auto &it, const auto &words, std::string &a
     return false; // Not a loop check command
 }
 
+inline bool processParallelCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*PARALLEL" || word == "*parallel") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Parallel compilation ON ("
+                        << CompilePool::getInstance().workerCount() << " workers)" << std::endl;
+                jc.parallelCompileON();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Parallel compilation OFF" << std::endl;
+                jc.parallelCompileOFF();
+            } else {
+                std::cerr << "Error: Expected argument (on,off) after " << word << std::endl;
+            }
+            // Remove `command` and `nextWord` from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), word.length() + nextWord.length() + 2);
+        }
+        return true; // Processed parallel command
+    }
+    return false; // Not a parallel command
+}
+
+inline bool processProfileCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*PROFILE" || word == "*profile") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            Profiler &profiler = Profiler::getInstance();
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Profiling ON" << std::endl;
+                profiler.start();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Profiling OFF" << std::endl;
+                profiler.stop();
+            } else if (nextWord == "REPORT" || nextWord == "report") {
+                profiler.report();
+            } else {
+                std::cerr << "Error: Expected argument (on,off,report) after " << word << std::endl;
+            }
+            // Remove `command` and `nextWord` from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), word.length() + nextWord.length() + 2);
+        }
+        return true; // Processed profile command
+    }
+    return false; // Not a profile command
+}
+
+// *PERF word n
+inline bool processPerfCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*PERF" || word == "*perf") {
+        // the command is removed on every path, left in it would run again with the next line
+        size_t length = word.length() + 1;
+        auto removeCommand = [&] {
+            accumulated_input.erase(accumulated_input.find(word), length);
+        };
+        // get the word and the iteration count
+        ++it;
+        if (it == words.end()) {
+            std::cerr << "Error: Expected word and count after " << word << std::endl;
+            removeCommand();
+            return true;
+        }
+        const auto &target = *it;
+        length += target.length() + 1;
+        ++it;
+        if (it == words.end()) {
+            std::cerr << "Error: Expected count after " << word << " " << target << std::endl;
+            removeCommand();
+            return true;
+        }
+        const auto &count = *it;
+        length += count.length() + 1;
+        try {
+            PerfCounters::measureWord(target, std::stoull(count));
+        } catch (const std::invalid_argument &) {
+            std::cerr << "Error: Invalid count " << count << std::endl;
+        } catch (const std::out_of_range &) {
+            std::cerr << "Error: Count out of range " << count << std::endl;
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+        removeCommand();
+        return true; // Processed perf command
+    }
+    return false; // Not a perf command
+}
+
+inline bool processStatsCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*STATS" || word == "*stats") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Word stats ON for words compiled from now on" << std::endl;
+                jc.wordStatsON();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Word stats OFF" << std::endl;
+                jc.wordStatsOFF();
+            } else if (nextWord == "RESET" || nextWord == "reset") {
+                WordStatsTable::getInstance().reset();
+            } else {
+                std::cerr << "Error: Expected argument (on,off,reset) after " << word << std::endl;
+            }
+            // Remove `command` and `nextWord` from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), word.length() + nextWord.length() + 2);
+        }
+        return true; // Processed stats command
+    }
+    return false; // Not a stats command
+}
+
+inline bool processExecutionTraceCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*TRACE" || word == "*trace") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            size_t consumed = word.length() + nextWord.length() + 2;
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Execution trace ON for words compiled from now on" << std::endl;
+                jc.traceON();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Execution trace OFF" << std::endl;
+                jc.traceOFF();
+            } else if (nextWord == "DUMP" || nextWord == "dump") {
+                // optional count of entries
+                uint64_t count = 32;
+                Token literal;
+                if (std::next(it) != words.end() && scan_literal(*std::next(it), literal) &&
+                    literal.type == TOKEN_NUMBER && literal.int_value >= 0) {
+                    ++it;
+                    count = static_cast<uint64_t>(literal.int_value);
+                    consumed += it->length() + 1;
+                }
+                ExecutionTrace::getInstance().dump(count);
+            } else if (nextWord == "CLEAR" || nextWord == "clear") {
+                ExecutionTrace::getInstance().clear();
+            } else {
+                std::cerr << "Error: Expected argument (on,off,dump [n],clear) after " << word << std::endl;
+            }
+            // Remove the command and its arguments from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), consumed);
+        }
+        return true; // Processed execution trace command
+    }
+    return false; // Not an execution trace command
+}
+
+inline bool processIndirectCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*INDIRECT" || word == "*indirect") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Indirect calls ON, colon definitions can be redefined" << std::endl;
+                jc.indirectCallsON();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Indirect calls OFF" << std::endl;
+                jc.indirectCallsOFF();
+            } else {
+                std::cerr << "Error: Expected argument (on,off) after " << word << std::endl;
+            }
+            // Remove `command` and `nextWord` from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), word.length() + nextWord.length() + 2);
+        }
+        return true; // Processed indirect command
+    }
+    return false; // Not an indirect command
+}
+
+inline bool processAutoJitCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    const auto &word = *it;
+    if (word == "*AUTOJIT" || word == "*autojit") {
+        // get next word
+        ++it;
+        if (it != words.end()) {
+            const auto &nextWord = *it;
+            if (nextWord == "ON" || nextWord == "on") {
+                std::cout << "Auto JIT ON, top level control flow runs as a temporary word" << std::endl;
+                jc.autoJitON();
+            } else if (nextWord == "OFF" || nextWord == "off") {
+                std::cout << "Auto JIT OFF" << std::endl;
+                jc.autoJitOFF();
+            } else {
+                std::cerr << "Error: Expected argument (on,off) after " << word << std::endl;
+            }
+            // Remove `command` and `nextWord` from accumulated_input
+            accumulated_input.erase(accumulated_input.find(word), word.length() + nextWord.length() + 2);
+        }
+        return true; // Processed auto JIT command
+    }
+    return false; // Not an auto JIT command
+}
+
 inline bool processLoggingCommands(auto &it, const auto &words, std::string &accumulated_input) {
     const auto &word = *it;
     if (word == "*LOGGING" || word == "*logging") {
@@ -808,6 +1404,35 @@ inline bool processDumpCommands(auto &it, const auto &words, std::string &accumu
     return false; // Not a dump command
 }
 
+// The * commands, it is left on the last word a command used.
+inline bool processMetaCommands(auto &it, const auto &words, std::string &accumulated_input) {
+    return processLoggingCommands(it, words, accumulated_input) ||
+           processTraceCommands(it, words, accumulated_input) ||
+           processLoopCheckCommands(it, words, accumulated_input) ||
+           processParallelCommands(it, words, accumulated_input) ||
+           processIndirectCommands(it, words, accumulated_input) ||
+           processProfileCommands(it, words, accumulated_input) ||
+           processStatsCommands(it, words, accumulated_input) ||
+           processExecutionTraceCommands(it, words, accumulated_input) ||
+           processAutoJitCommands(it, words, accumulated_input) ||
+           processPerfCommands(it, words, accumulated_input) ||
+           processDumpCommands(it, words, accumulated_input);
+}
+
+// Run a line of * commands outside the terminal, e.g. from the command line.
+inline void runMetaCommands(const std::string &line) {
+    if (handleSpecialCommands(line).empty()) return;
+
+    std::string accumulated_input = line;
+    const auto words = split(line);
+    for (auto it = words.begin(); it != words.end();) {
+        if (!processMetaCommands(it, words, accumulated_input)) {
+            throw std::runtime_error("Not a * command: " + *it);
+        }
+        if (it != words.end()) ++it;
+    }
+}
+
 inline void interactive_terminal() {
     struct termios orig_termios;
     enable_raw_mode(&orig_termios);
@@ -819,6 +1444,8 @@ inline void interactive_terminal() {
 
     // The infinite terminal loop
     while (true) {
+        // no JIT code is running here, forgotten words can give back their memory
+        jc.releasePendingCode();
         std::cout << (compiling ? "] " : "> ");
         std::cout.flush();
         custom_getline(std::cin, input); // Read a line of input from the terminal
@@ -847,19 +1474,8 @@ inline void interactive_terminal() {
                 break;
             }
 
-            if (processLoggingCommands(it, words, accumulated_input)) {
-                continue;
-            }
-
-            if (processTraceCommands(it, words, accumulated_input)) {
-                continue;
-            }
-
-            if (processLoopCheckCommands(it, words, accumulated_input)) {
-                continue;
-            }
-
-            if (processDumpCommands(it, words, accumulated_input)) {
+            if (processMetaCommands(it, words, accumulated_input)) {
+                if (it == words.end()) break; // a command missing its argument
                 continue;
             }
 
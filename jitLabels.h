@@ -90,11 +90,12 @@ struct LoopLabel
     LabelVariant label;
 };
 
-inline std::stack<LoopLabel> loopStack;
+// control flow state belongs to the thread compiling the word
+inline thread_local std::stack<LoopLabel> loopStack;
 
-inline int doLoopDepth = 0;
+inline thread_local int doLoopDepth = 0;
 
-inline std::stack<LoopLabel> tempLoopStack;
+inline thread_local std::stack<LoopLabel> tempLoopStack;
 
 // save stack to tempLoopStack
 
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <csignal>
 #include <csetjmp> // Required for setjmp and longjmp
+#include <cstdlib>
+#include <fstream>
 
 #include "quit.h"
 #include "interpreter.h"
@@ -22,6 +24,7 @@ const char *exception_messages[] = {
 };
 
 static jmp_buf quit_env; // Jump buffer for error handling
+static bool quit_env_set = false; // only Quit recovers by longjmp
 
 // Function to raise an exception
 void raise_c(int eno) {
@@ -32,6 +35,11 @@ void raise_c(int eno) {
         eno = 0; // Default to "Unknown error"
     }
 
+    // batch runs own files and strings on the way down, they unwind as an exception
+    if (!quit_env_set) {
+        throw std::runtime_error(exception_messages[eno]);
+    }
+
     fprintf(stderr, "FORTH RUNTIME ERROR: %s (Error %d)\n", exception_messages[eno], eno);
 
     // Instead of exiting, jump back to Quit()'s saved state
@@ -49,6 +57,8 @@ void Quit() {
 
     // Set up the signal handler for SIGINT
     signal(SIGINT, handle_sigint);
+    add_interpreter_words();
+    quit_env_set = true;
 
     // Main program loop
     while (true) {
@@ -83,8 +93,58 @@ void Quit() {
             sm.resetLS(); // Reset local stack
             sm.resetSS(); // Reset state stack
             sm.resetRS(); // Reset return stack
+            jc.releasePendingCode();
+
+            // what ran last, when words were compiled with *TRACE ON
+            if (ExecutionTrace::getInstance().ring()->next > 0) {
+                ExecutionTrace::getInstance().dump(16, std::cerr);
+            }
 
             // The `while(true)` ensures the loop continues after recovery
         }
     }
-}
\ No newline at end of file
+}
+
+
+int RunBatch(const std::vector<BatchSource> &sources) {
+    add_interpreter_words();
+    echo_enabled = false;
+    sm.resetDS();
+    sm.resetLS();
+    sm.resetSS();
+    sm.resetRS();
+
+    // no setjmp here, errors reach the catch below with the sources unwound
+    try {
+        for (const auto &source: sources) {
+            switch (source.kind) {
+                case BatchSource::SCRIPT:
+                    includeFile(source.text);
+                    break;
+                case BatchSource::CODE:
+                    interpretText(source.text);
+                    break;
+                case BatchSource::COMMAND:
+                    runMetaCommands(source.text);
+                    break;
+                case BatchSource::STDIN: {
+                    // a filebuf of its own reads in blocks, std::cin synced with stdio reads by the byte
+                    std::ifstream input("/dev/stdin");
+                    interpretLines(input);
+                    break;
+                }
+            }
+            jc.releasePendingCode();
+        }
+    } catch (const std::exception &e) {
+        fflush(stdout);
+        std::cerr << "Error: " << e.what() << std::endl;
+        // what ran last, when words were compiled with *TRACE ON
+        if (ExecutionTrace::getInstance().ring()->next > 0) {
+            ExecutionTrace::getInstance().dump(16, std::cerr);
+        }
+        return EXIT_FAILURE;
+    }
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}
@@ -2,9 +2,21 @@
 #ifndef QUIT_H
 #define QUIT_H
 #include <csetjmp>
+#include <string>
 #include <thread>
+#include <vector>
 
 void Quit();  // Declaration of Quit function
+
+// One input of a batch run, taken in command line order
+struct BatchSource {
+    enum Kind { SCRIPT, CODE, STDIN, COMMAND } kind;
+    std::string text; // file name, code or a line of * commands (*TRACE ON, *PERF word n ...)
+};
+
+// Run the sources without the terminal, returns the process exit status:
+// 0 when all of them ran, 1 after the first error, which ends the run.
+int RunBatch(const std::vector<BatchSource> &sources);
 bool escapePressed();
 static jmp_buf jumpBuffer;
 #endif // QUIT_H
\ No newline at end of file
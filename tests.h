@@ -6,6 +6,7 @@
 #define TESTS_H
 #include <iostream>
 #include <string>
+#include <string_view>
 #include "CompilerUtility.h"
 #include "Compiler.h"
 
@@ -18,10 +19,9 @@ inline void run_word(const std::string& word)
     ForthWord* w = d.findWord(word.c_str());
     if (w == nullptr)
     {
-        if (is_number(word))
+        if (Token literal; scan_literal(word, literal) && literal.type == TOKEN_NUMBER)
         {
-            uint64_t num = parseNumber(word);
-            sm.pushDS(num);
+            sm.pushDS(static_cast<uint64_t>(literal.int_value));
         }
         else
         {
@@ -35,16 +35,18 @@ inline void run_word(const std::string& word)
     }
 }
 
-void interpreter(const std::string& sourceCode);
+void interpreter(std::string_view sourceCode);
+void interpretText(std::string_view text);
 
 
-inline void test_against_ds(const std::string& words, const uint64_t expected_top)
+inline void test_against_ds(const std::string& words, const uint64_t expected_top,
+                            void (*run)(std::string_view) = interpreter)
 {
     try
     {
         sm.resetDS(); // to get a clean stack
         std::cout << "Running: " << words << std::endl;
-        interpreter(words);
+        run(words);
 
         uint64_t result = sm.popDS();
         total_tests++;
@@ -269,6 +271,59 @@ void run_basic_tests()
 
     test_against_ds(" 77 value testval 99 to testval testval forget ", 99);
 
+    // the second shadowv is found first, after forget the lookup has to see the first again
+    test_against_ds(" 1 value shadowv 2 value shadowv shadowv forget shadowv forget + ", 3);
+
+    // marker forgets itself and everything after it, the second run would fail if tidyword survived
+    test_against_ds(" marker --tidy 5 value tidyval 3 array tidyarr tidyval --tidy ", 5);
+    test_against_ds(" marker --tidy : tidyword 41 1+ ; tidyword --tidy ", 42);
+    test_against_ds(" marker --tidy : tidyword 41 1+ ; tidyword --tidy ", 42);
+
+    // redefinition through the indirect call slot, the second redefinition calls the old code
+    jc.indirectCallsON();
+    test_against_ds(" : redef1 10 ; : redef2 redef1 1+ ; : redef1 20 ; redef2 ", 21);
+    test_against_ds(" : redef1 redef1 5 + ; redef2 ", 26);
+    // the marker releases the replaced code with the word
+    test_against_ds(" marker --redef : redef3 1 ; : redef3 redef3 1+ ; redef3 --redef ", 2);
+    jc.indirectCallsOFF();
+
+    // stats instrumentation keeps the machine stack balanced, also through EXIT
+    jc.wordStatsON();
+    test_against_ds(" : statword 1 2 + ; statword ", 3);
+    test_against_ds(" : statexit 5 exit 6 ; statexit ", 5);
+    jc.wordStatsOFF();
+
+    // trace instrumentation leaves the data stack alone
+    jc.traceON();
+    test_against_ds(" : traceword 4 5 * ; 1 traceword + ", 21);
+    jc.traceOFF();
+
+    // literals are read in BASE, prefixed literals and full 64 bit values
+    test_against_ds(" hex 0ff decimal ", 255);
+    test_against_ds(" 2 base ! 101 decimal 0x10 + ", 21);
+    test_against_ds(" 9223372036854775807 ", 9223372036854775807ULL);
+    test_against_ds(" -9223372036854775808 ", 9223372036854775808ULL);
+    test_against_ds(" 0xffffffffffffffff ", UINT64_MAX);
+    test_against_ds(" hex 0b1 decimal ", 0xb1);
+    // compileWord reads literals with the same scan, the sign stays on prefixed ones
+    testCompileAndRun("testNegHex", "-0x10 1 +", "testNegHex", -15);
+
+    // par1 and par2 compile together on the pool, par3 waits for them to be published
+    jc.parallelCompileON();
+    test_against_ds(" : par1 1 ; : par2 2 ; : par3 par1 par2 + ; par3 ", 3, interpretText);
+    // the scan ahead leaves literals alone, 22 ones would not fit in decimal
+    test_against_ds(" 2 base ! : par4 1111111111111111111111 ; decimal par4 ", 4194303, interpretText);
+    jc.parallelCompileOFF();
+
+    // EVALUATE interprets the first time, the second runs the string compiled
+    test_against_ds(" s\" 20 1+\" zcount over over evaluate >r evaluate r> + ", 42);
+    // BASE changes inside the string stay interpreted, both runs read 10 in hex
+    test_against_ds(" s\" hex 10 decimal\" zcount over over evaluate >r evaluate r> + ", 32);
+
+    // top level control flow runs as a temporary word
+    test_against_ds(" 0 10 0 do i + loop ", 45);
+    test_against_ds(" 1 begin 2* dup 100 > until ", 128);
+
 
     // compiled word tests
     testCompileAndRun("testWord",
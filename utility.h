@@ -9,6 +9,7 @@
 #include <bitset>
 #include <iomanip>
 #include <cstdint>
+#include <stdexcept>
 
 extern "C" {
 inline void putchars(const char *s) {
@@ -55,66 +56,6 @@ inline std::string trim(const std::string &str) {
     return str.substr(first, (last - first + 1));
 }
 
-inline bool is_float(const std::string &s) {
-    if (s.empty()) return false;
-    size_t startIndex = 0;
-    bool hasDecimalPoint = false;
-
-    // Check for an optional leading minus
-    if (s[0] == '-') {
-        if (s.length() == 1) return false; // only '-' is not a valid number
-        startIndex = 1;
-    }
-
-    // Check each character in the string
-    for (size_t i = startIndex; i < s.length(); ++i) {
-        if (s[i] == '.') {
-            if (hasDecimalPoint) return false; // More than one decimal point is not valid
-            hasDecimalPoint = true;
-        } else if (!std::isdigit(s[i])) {
-            return false; // Non-digit characters other than a single decimal point are not valid
-        }
-    }
-
-    // Ensure there's at least one digit if it has a leading minus
-    return hasDecimalPoint && s.length() > startIndex + 1;
-}
-
-
-inline bool is_number(const std::string &s) {
-    if (s.empty()) return false;
-    size_t startIndex = 0;
-
-    // Check for an optional leading minus
-    if (s[0] == '-') {
-        if (s.length() == 1) return false; // only '-' is not a valid number
-        startIndex = 1;
-    }
-
-    if (startIndex + 2 < s.length() && s[startIndex] == '0') {
-        if (s[startIndex + 1] == 'x' || s[startIndex + 1] == 'X') // Hexadecimal check
-        {
-            for (size_t i = startIndex + 2; i < s.length(); ++i) {
-                if (!std::isxdigit(s[i])) return false;
-            }
-            return true;
-        } else if (s[startIndex + 1] == 'b' || s[startIndex + 1] == 'B') // Binary check
-        {
-            for (size_t i = startIndex + 2; i < s.length(); ++i) {
-                if (s[i] != '0' && s[i] != '1') return false;
-            }
-            return true;
-        }
-    }
-
-    // Decimal check
-    for (size_t i = startIndex; i < s.length(); ++i) {
-        if (!std::isdigit(s[i])) return false;
-    }
-
-    return true;
-}
-
 inline std::vector<std::string> split(const std::string &str) {
     std::vector<std::string> result;
     std::istringstream iss(str);